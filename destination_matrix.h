@@ -0,0 +1,140 @@
+#ifndef DESTINATION_MATRIX_H
+#define DESTINATION_MATRIX_H
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "sim_config.h"
+#include "sim_random.h"
+
+// Walker/Vose alias table over n outcomes: draw a column uniformly, then
+// keep it if a 32-bit coin is below its threshold, otherwise take its alias.
+// Any distribution costs two draws and no search.
+class AliasTable {
+public:
+    std::vector<uint64_t> threshold; // Out of 2^32
+    std::vector<int> alias;
+
+    // weights need not sum to 1 but must have a positive sum
+    void build(const double* weights, int n) {
+        threshold.assign(n, 0);
+        alias.assign(n, 0);
+        double total = 0;
+        for (int k = 0; k < n; k++) {
+            total += weights[k];
+        }
+        std::vector<double> scaled(n);
+        std::vector<int> small, large;
+        for (int k = 0; k < n; k++) {
+            scaled[k] = weights[k] * n / total;
+            (scaled[k] < 1 ? small : large).push_back(k);
+        }
+        while (!small.empty() && !large.empty()) {
+            int less = small.back();
+            int more = large.back();
+            small.pop_back();
+            threshold[less] = (uint64_t)(scaled[less] * 4294967296.0);
+            alias[less] = more;
+            scaled[more] -= 1 - scaled[less];
+            if (scaled[more] < 1) {
+                large.pop_back();
+                small.push_back(more);
+            }
+        }
+        // Whatever is left is 1 up to rounding
+        for (int k : large) {
+            threshold[k] = (uint64_t)1 << 32;
+            alias[k] = k;
+        }
+        for (int k : small) {
+            threshold[k] = (uint64_t)1 << 32;
+            alias[k] = k;
+        }
+    }
+
+    int resolve(int column, uint32_t coin) const {
+        return coin < threshold[column] ? column : alias[column];
+    }
+};
+
+// Output port distribution of each input. Patterns whose rows are all the
+// same (hotspot) or all rotations of one row (diagonal, log-diagonal,
+// unbalanced) share a single table; a matrix file gets one table per input.
+class DestinationMatrix {
+public:
+    explicit DestinationMatrix(const SimConfig& config)
+        : numPorts(config.numPorts), pattern(config.destinations) {
+        int n = numPorts;
+        std::vector<double> row(n, 0.0);
+        switch (pattern) {
+        case DEST_HOTSPOT:
+            for (int j = 0; j < n; j++) {
+                row[j] = (1 - config.hotspotFraction) / n + (j < config.hotspots ? config.hotspotFraction / config.hotspots : 0);
+            }
+            break;
+        case DEST_DIAGONAL:
+            // 2/3 to output i, 1/3 to output i + 1
+            row[0] = 2.0 / 3;
+            row[1 % n] += 1.0 / 3;
+            rotate = true;
+            break;
+        case DEST_LOG_DIAGONAL:
+            // Output i + k gets twice the rate of output i + k + 1
+            for (int k = 0, exponent = 0; k < n; k++, exponent--) {
+                row[k] = std::ldexp(1.0, exponent);
+            }
+            rotate = true;
+            break;
+        case DEST_UNBALANCED:
+            // Share omega to output i, the rest spread evenly
+            for (int k = 0; k < n; k++) {
+                row[k] = (1 - config.unbalancedOmega) / n;
+            }
+            row[0] += config.unbalancedOmega;
+            rotate = true;
+            break;
+        default:
+            break;
+        }
+
+        if (pattern == DEST_FILE) {
+            tables.resize(n);
+            for (int i = 0; i < n; i++) {
+                tables[i].build(&config.destinationMatrix[(size_t)i * n], n);
+            }
+        } else if (pattern != DEST_UNIFORM) {
+            tables.resize(1);
+            tables[0].build(row.data(), n);
+        }
+    }
+
+    bool uniform() const { return pattern == DEST_UNIFORM; }
+
+    // Output for input from a uniform column in [0, numPorts) and a 32-bit coin
+    int resolve(int inputPort, int column, uint32_t coin) const {
+        if (pattern == DEST_FILE) {
+            return tables[inputPort].resolve(column, coin);
+        }
+        int k = tables[0].resolve(column, coin);
+        if (rotate) {
+            k += inputPort;
+            if (k >= numPorts) {
+                k -= numPorts;
+            }
+        }
+        return k;
+    }
+
+    int sample(SimRandom& random, int inputPort) const {
+        int column = random.uniformInt(numPorts);
+        return uniform() ? column : resolve(inputPort, column, random.next32());
+    }
+
+private:
+    int numPorts;
+    DestinationPattern pattern;
+    bool rotate = false;
+    std::vector<AliasTable> tables;
+};
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef DRRM_H
+#define DRRM_H
+
+#include <vector>
+#include "matching_scheduler.h"
+
+// Dual Round-Robin Matching: each input requests a single output, chosen
+// round-robin among its non-empty VOQs; each output grants one request
+// round-robin. A grant is a match, so there is no accept phase. An input
+// pointer only moves when its request is granted.
+class DrrmScheduler : public MatchingScheduler {
+public:
+    std::vector<int> requestPointer; // Per input
+    std::vector<int> grantPointer;   // Per output
+
+    std::vector<MaskWord> requestMask;  // Inputs requesting each output, words per output
+    std::vector<MaskWord> requestedOutputs;
+    std::vector<MaskWord> allPorts;
+
+    explicit DrrmScheduler(const SimConfig& config)
+        : MatchingScheduler(config),
+          requestPointer(numPorts, 0),
+          grantPointer(numPorts, 0),
+          requestMask(numPorts * words, 0),
+          requestedOutputs(words, 0),
+          allPorts(words, 0) {
+        fillMask(allPorts.data(), numPorts);
+    }
+
+    template <class Switch>
+    void processPackets(Switch& sw, int time);
+};
+
+template <class Switch>
+void DrrmScheduler::processPackets(Switch& sw, int time) {
+    const MaskWord* activeInputs = sw.occupied.activeInputs();
+    if (maskEmpty(activeInputs, words)) {
+        return;
+    }
+    resetMatching();
+
+    markPhase(PROFILE_MATCH);
+    //request phase: every busy input picks one output
+    for (int w = 0; w < words; w++) {
+        MaskWord inputs = activeInputs[w];
+        while (inputs) {
+            int inputPort = (w << 6) + __builtin_ctzll(inputs);
+            inputs &= inputs - 1;
+            int outputPort = roundRobinPick(sw.occupied.byInput(inputPort), allPorts.data(), words, requestPointer[inputPort]);
+            setPort(&requestMask[outputPort * words], inputPort);
+            setPort(requestedOutputs.data(), outputPort);
+        }
+    }
+
+    markPhase(PROFILE_REQUEST);
+    //grant phase: every requested output picks one input
+    for (int w = 0; w < words; w++) {
+        MaskWord outputs = requestedOutputs[w];
+        while (outputs) {
+            int outputPort = (w << 6) + __builtin_ctzll(outputs);
+            outputs &= outputs - 1;
+            MaskWord* requests = &requestMask[outputPort * words];
+            int inputPort = roundRobinPick(requests, allPorts.data(), words, grantPointer[outputPort]);
+            clearMask(requests, words);
+            addMatch(inputPort, outputPort);
+            grantPointer[outputPort] = (inputPort + 1) % numPorts;
+            requestPointer[inputPort] = (outputPort + 1) % numPorts;
+        }
+    }
+    clearMask(requestedOutputs.data(), words);
+    markPhase(PROFILE_GRANT);
+
+    transmitMatches(sw, time);
+}
+
+#endif
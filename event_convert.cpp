@@ -0,0 +1,185 @@
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "event_trace.h"
+
+using namespace std;
+
+static const size_t READ_BATCH = 4096; // Events per read
+
+static void printUsage(const char* program) {
+    cout << "Usage: " << program << " [--from SLOT] [--to SLOT] INPUT OUTPUT" << endl;
+    cout << "Converts an event file written by router_sim --event_file into Chrome trace" << endl;
+    cout << "JSON, which chrome://tracing and ui.perfetto.dev open. Each input and output" << endl;
+    cout << "port is a track; a slot spans 1 ms, split into its scheduling phases." << endl;
+    cout << "  --from, --to   Keep only the events of slots FROM to TO, inclusive" << endl;
+}
+
+// Input-side events go on the input's track, the rest on the output's
+static bool onOutputTrack(const TraceEvent& event) {
+    return event.type == EVENT_GRANT || event.type == EVENT_OUTPUT_DROP ||
+           (event.type == EVENT_POINTER && event.round == POINTER_GRANT);
+}
+
+// Microseconds into the slot: arrivals first, then within each phase
+// requests, grant and accept rounds, pointer moves and dequeues, so the
+// order on a track follows the order of the decisions
+static int stageOffset(const TraceEvent& event) {
+    int offset = 0;
+    switch (event.type) {
+    case EVENT_REQUEST:
+        offset = 10;
+        break;
+    case EVENT_GRANT:
+        offset = 20 + 2 * min<int>(event.round, 30);
+        break;
+    case EVENT_ACCEPT:
+        offset = 21 + 2 * min<int>(event.round, 30);
+        break;
+    case EVENT_POINTER:
+        offset = 85;
+        break;
+    case EVENT_DEQUEUE:
+        offset = 90;
+        break;
+    case EVENT_OUTPUT_DROP:
+        offset = 95;
+        break;
+    default:
+        return 0; // Enqueue and drop happen before the first phase
+    }
+    return 100 + min<int>(event.phase, 8) * 100 + offset;
+}
+
+static void writeEvent(FILE* out, const TraceEvent& event, bool& first) {
+    bool outputTrack = onOutputTrack(event);
+    const char* name = eventTypeName(event.type);
+    if (event.type == EVENT_POINTER) {
+        name = event.round == POINTER_GRANT ? "grant_pointer" : "accept_pointer";
+    }
+    fprintf(out, "%s{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%llu,\"pid\":%d,\"tid\":%u,"
+                 "\"args\":{\"slot\":%u,\"phase\":%u,\"input\":%u,\"output\":%u",
+            first ? "" : ",\n", name, (unsigned long long)event.slot * 1000 + stageOffset(event), outputTrack ? 2 : 1,
+            outputTrack ? event.output : event.input, event.slot, event.phase, event.input, event.output);
+    switch (event.type) {
+    case EVENT_ENQUEUE:
+    case EVENT_DROP:
+    case EVENT_OUTPUT_DROP:
+        fprintf(out, ",\"cells\":%d,\"class\":%u}}", event.value, event.round);
+        break;
+    case EVENT_GRANT:
+    case EVENT_ACCEPT:
+        fprintf(out, ",\"iteration\":%u}}", event.round);
+        break;
+    case EVENT_DEQUEUE:
+        fprintf(out, ",\"waited\":%d,\"class\":%u}}", event.value, event.round);
+        break;
+    case EVENT_POINTER:
+        fprintf(out, ",\"position\":%d}}", event.value);
+        break;
+    default:
+        fprintf(out, "}}");
+    }
+    first = false;
+}
+
+static void writeTrackNames(FILE* out, int numPorts, bool& first) {
+    const char* processes[2] = {"Inputs", "Outputs"};
+    for (int pid = 1; pid <= 2; pid++) {
+        fprintf(out, "%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",\n", pid, processes[pid - 1]);
+        first = false;
+        for (int port = 0; port < numPorts; port++) {
+            fprintf(out, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s %d\"}}",
+                    pid, port, pid == 1 ? "Input" : "Output", port);
+        }
+    }
+}
+
+static bool parseSlot(const char* text, unsigned long long& slot) {
+    istringstream value(text);
+    value >> slot;
+    return value && value.eof() && text[0] != '-';
+}
+
+int main(int argc, char* argv[]) {
+    unsigned long long from = 0;
+    unsigned long long to = ~0ull;
+    vector<string> paths;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if ((arg == "--from" || arg == "--to") && i + 1 < argc) {
+            if (!parseSlot(argv[++i], arg == "--from" ? from : to)) {
+                cout << "Error: " << arg << " must be a slot number" << endl;
+                return 1;
+            }
+        } else {
+            paths.push_back(arg);
+        }
+    }
+    if (paths.size() != 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    FILE* in = fopen(paths[0].c_str(), "rb");
+    if (!in) {
+        cout << "Error: cannot open '" << paths[0] << "'" << endl;
+        return 1;
+    }
+    EventHeader header;
+    if (fread(&header, sizeof(header), 1, in) != 1 || memcmp(header.magic, EVENT_MAGIC, sizeof(EVENT_MAGIC)) != 0) {
+        fclose(in);
+        cout << "Error: " << paths[0] << ": not an event file" << endl;
+        return 1;
+    }
+    if (header.version != EVENT_VERSION) {
+        fclose(in);
+        cout << "Error: " << paths[0] << ": unsupported event file version " << header.version << endl;
+        return 1;
+    }
+    FILE* out = fopen(paths[1].c_str(), "wb");
+    if (!out) {
+        fclose(in);
+        cout << "Error: cannot write '" << paths[1] << "'" << endl;
+        return 1;
+    }
+    setvbuf(out, nullptr, _IOFBF, 1 << 20);
+
+    fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    writeTrackNames(out, (int)header.numPorts, first);
+    vector<TraceEvent> events(READ_BATCH);
+    uint64_t read = 0;
+    uint64_t written = 0;
+    while (read < header.count) {
+        size_t want = (size_t)min<uint64_t>(READ_BATCH, header.count - read);
+        size_t got = fread(events.data(), sizeof(TraceEvent), want, in);
+        for (size_t k = 0; k < got; k++) {
+            if (events[k].slot >= from && events[k].slot <= to) {
+                writeEvent(out, events[k], first);
+                written++;
+            }
+        }
+        read += got;
+        if (got < want) {
+            break;
+        }
+    }
+    fprintf(out, "\n]}\n");
+    fclose(in);
+    bool ok = !ferror(out);
+    ok = fclose(out) == 0 && ok;
+    if (!ok) {
+        cout << "Error: " << paths[1] << ": error writing the JSON" << endl;
+        return 1;
+    }
+    if (read < header.count) {
+        cout << "Warning: " << paths[0] << " is truncated, read " << read << " of " << header.count << " events" << endl;
+    }
+    cout << "Wrote " << written << " events over " << header.numPorts << " ports" << endl;
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include <chrono>
+#include <cstring>
+#include "event_trace.h"
+
+using namespace std;
+
+const char* eventTypeName(int type) {
+    switch (type) {
+    case EVENT_ENQUEUE:
+        return "enqueue";
+    case EVENT_DROP:
+        return "drop";
+    case EVENT_REQUEST:
+        return "request";
+    case EVENT_GRANT:
+        return "grant";
+    case EVENT_ACCEPT:
+        return "accept";
+    case EVENT_DEQUEUE:
+        return "dequeue";
+    case EVENT_POINTER:
+        return "pointer";
+    case EVENT_OUTPUT_DROP:
+        return "output_drop";
+    default:
+        return "unknown";
+    }
+}
+
+EventTracer::~EventTracer() {
+    if (file) {
+        string error;
+        close(error);
+    }
+}
+
+bool EventTracer::open(const string& path, int numPorts, string& error) {
+    file = fopen(path.c_str(), "wb");
+    if (!file) {
+        error = "cannot write '" + path + "'";
+        return false;
+    }
+    this->numPorts = numPorts;
+    ring.assign(CAPACITY, TraceEvent());
+    // Placeholder until close() knows the count
+    EventHeader header = {};
+    failed = fwrite(&header, sizeof(header), 1, file) != 1;
+    writer = thread(&EventTracer::writeLoop, this);
+    return true;
+}
+
+void EventTracer::waitForRoom(uint64_t h) {
+    freedTail = tail.load(memory_order_acquire);
+    while (h - freedTail >= CAPACITY) {
+        this_thread::yield();
+        freedTail = tail.load(memory_order_acquire);
+    }
+}
+
+// Writes published events in at most two runs, where the ring wraps. An
+// idle writer sleeps briefly instead of spinning against the simulation.
+void EventTracer::writeLoop() {
+    uint64_t t = tail.load(memory_order_relaxed);
+    while (true) {
+        bool done = stopping.load(memory_order_acquire);
+        uint64_t h = head.load(memory_order_acquire);
+        if (h == t) {
+            if (done) {
+                return;
+            }
+            this_thread::sleep_for(chrono::microseconds(200));
+            continue;
+        }
+        while (t != h) {
+            size_t start = (size_t)(t & (CAPACITY - 1));
+            size_t run = (size_t)min<uint64_t>(h - t, CAPACITY - start);
+            if (fwrite(&ring[start], sizeof(TraceEvent), run, file) != run) {
+                failed = true;
+            }
+            t += run;
+        }
+        tail.store(t, memory_order_release);
+    }
+}
+
+bool EventTracer::close(string& error) {
+    stopping.store(true, memory_order_release);
+    writer.join();
+
+    EventHeader header = {};
+    memcpy(header.magic, EVENT_MAGIC, sizeof(EVENT_MAGIC));
+    header.version = EVENT_VERSION;
+    header.numPorts = (uint32_t)numPorts;
+    header.count = head.load(memory_order_relaxed);
+    bool ok = !failed && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = !ferror(file) && ok;
+    ok = fclose(file) == 0 && ok;
+    file = nullptr;
+    if (!ok) {
+        error = "error writing the event trace";
+    }
+    return ok;
+}
+
+bool openEvents(SimConfig& config, const string& tag, string& error) {
+    config.events.reset();
+    if (config.eventFile.empty()) {
+        return true;
+    }
+    if (!EVENT_TRACING) {
+        error = "event_file needs a build with EVENT_TRACE=1";
+        return false;
+    }
+    shared_ptr<EventTracer> events(new EventTracer());
+    if (!events->open(taggedPath(config.eventFile, tag), config.numPorts, error)) {
+        return false;
+    }
+    config.events = events;
+    return true;
+}
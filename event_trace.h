@@ -0,0 +1,129 @@
+#ifndef EVENT_TRACE_H
+#define EVENT_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "sim_config.h"
+
+// Build with EVENT_TRACE=0 to compile every trace point out. Built in, a
+// run without an event file pays one null check per packet in the engine;
+// the matchers pick a traced or an untraced copy of their loops once per
+// slot, so their inner loops carry no trace code unless tracing is on.
+#ifndef EVENT_TRACE
+#define EVENT_TRACE 1
+#endif
+const bool EVENT_TRACING = EVENT_TRACE != 0;
+
+// Binary event file: an EventHeader followed by count TraceEvents in the
+// order they happened, all little-endian
+const char EVENT_MAGIC[8] = {'V', 'O', 'Q', 'E', 'V', 'E', 'N', 'T'};
+const uint32_t EVENT_VERSION = 1;
+
+enum TraceEventType : uint8_t {
+    EVENT_ENQUEUE = 0,     // Packet joined VOQ (input, output); value = cells, round = class
+    EVENT_DROP = 1,        // Packet found VOQ (input, output) full; value = cells, round = class
+    EVENT_REQUEST = 2,     // Input asks output for a match
+    EVENT_GRANT = 3,       // Output grants input; round = iteration
+    EVENT_ACCEPT = 4,      // Input accepts output; round = iteration
+    EVENT_DEQUEUE = 5,     // Head cell of VOQ (input, output) crossed; value = slots waited, round = class
+    EVENT_POINTER = 6,     // Arbiter pointer moved; value = new position, round = EventPointer
+    EVENT_OUTPUT_DROP = 7, // Packet found output's queue full; value = cells
+    EVENT_TYPES = 8
+};
+
+// Which pointer an EVENT_POINTER moved, and which port owns it
+enum EventPointer : uint8_t {
+    POINTER_GRANT = 0,  // Of the output
+    POINTER_ACCEPT = 1  // Of the input
+};
+
+struct EventHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t numPorts;
+    uint64_t count;
+    uint64_t reserved;
+};
+
+struct TraceEvent {
+    uint32_t slot;
+    uint8_t type;
+    uint8_t round;   // Iteration, class or pointer kind, by type
+    uint16_t phase;  // Scheduling phase within the slot, for speedup above 1
+    uint16_t input;
+    uint16_t output;
+    int32_t value;
+};
+
+static_assert(sizeof(EventHeader) == 32, "event header layout");
+static_assert(sizeof(TraceEvent) == 16, "event record layout");
+
+const char* eventTypeName(int type);
+
+// Single-producer ring buffer of events. The simulation thread stores an
+// event and publishes it by moving head; a writer thread copies published
+// events to the file and frees them by moving tail. Neither side takes a
+// lock. A producer that catches up with the writer waits for it, so no
+// event is lost.
+class EventTracer {
+public:
+    static const size_t CAPACITY = 1 << 16; // Events, a power of two
+
+    EventTracer() {}
+    ~EventTracer();
+    EventTracer(const EventTracer&) = delete;
+    EventTracer& operator=(const EventTracer&) = delete;
+
+    bool open(const std::string& path, int numPorts, std::string& error);
+    // Drains the ring, fills in the header and stops the writer
+    bool close(std::string& error);
+
+    // Stamps the events that follow
+    void setSlot(int time, int phaseInSlot) {
+        slot = (uint32_t)time;
+        phase = (uint16_t)phaseInSlot;
+    }
+
+    void record(TraceEventType type, int input, int output, int value = 0, int round = 0) {
+        uint64_t h = head.load(std::memory_order_relaxed);
+        if (h - freedTail >= CAPACITY) {
+            waitForRoom(h);
+        }
+        TraceEvent& event = ring[h & (CAPACITY - 1)];
+        event.slot = slot;
+        event.type = type;
+        event.round = (uint8_t)round;
+        event.phase = phase;
+        event.input = (uint16_t)input;
+        event.output = (uint16_t)output;
+        event.value = value;
+        head.store(h + 1, std::memory_order_release);
+    }
+
+private:
+    void waitForRoom(uint64_t h);
+    void writeLoop();
+
+    std::vector<TraceEvent> ring;
+    std::atomic<uint64_t> head{0}; // Events published
+    std::atomic<uint64_t> tail{0}; // Events written
+    std::atomic<bool> stopping{false};
+    uint64_t freedTail = 0;        // Producer's last look at tail
+    uint32_t slot = 0;
+    uint16_t phase = 0;
+
+    FILE* file = nullptr;
+    int numPorts = 0;
+    bool failed = false;
+    std::thread writer;
+};
+
+// Opens config.eventFile into config.events, or clears it when no file is
+// set; the tag names the scheduler as in openMetrics
+bool openEvents(SimConfig& config, const std::string& tag, std::string& error);
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef HOPCROFT_KARP_H
+#define HOPCROFT_KARP_H
+
+#include <vector>
+#include "matching_scheduler.h"
+
+// Maximum size matching (Hopcroft-Karp) over the non-empty VOQs. It is an
+// upper bound on how many packets any scheduler can move in a slot, not a
+// practical scheduler: it can starve VOQs under non-uniform load.
+// Runs in O(E sqrt(N)) per slot, with edges read from the VOQ bitmaps.
+class MaxSizeScheduler : public MatchingScheduler {
+public:
+    std::vector<int> matchedInput; // Input matched to each output, -1 if none
+    std::vector<int> distance;     // BFS layer of each input
+    std::vector<int> bfsQueue;
+
+    explicit MaxSizeScheduler(const SimConfig& config)
+        : MatchingScheduler(config),
+          matchedInput(numPorts, -1),
+          distance(numPorts, 0),
+          bfsQueue(numPorts, 0) {}
+
+    template <class Switch>
+    void processPackets(Switch& sw, int time);
+
+private:
+    static const int UNREACHED = 1 << 30;
+
+    bool buildLayers(const VoqBitmaps& occupied);
+    bool augment(const VoqBitmaps& occupied, int inputPort);
+};
+
+// BFS from every free busy input; true if some free output is reachable
+inline bool MaxSizeScheduler::buildLayers(const VoqBitmaps& occupied) {
+    int head = 0, tail = 0;
+    const MaskWord* activeInputs = occupied.activeInputs();
+    for (int inputPort = 0; inputPort < numPorts; inputPort++) {
+        if (accepted[inputPort] == -1 && testPort(activeInputs, inputPort)) {
+            distance[inputPort] = 0;
+            bfsQueue[tail++] = inputPort;
+        } else {
+            distance[inputPort] = UNREACHED;
+        }
+    }
+    bool foundFree = false;
+    while (head < tail) {
+        int inputPort = bfsQueue[head++];
+        const MaskWord* outputs = occupied.byInput(inputPort);
+        for (int w = 0; w < words; w++) {
+            MaskWord bits = outputs[w];
+            while (bits) {
+                int outputPort = (w << 6) + __builtin_ctzll(bits);
+                bits &= bits - 1;
+                int next = matchedInput[outputPort];
+                if (next == -1) {
+                    foundFree = true;
+                } else if (distance[next] == UNREACHED) {
+                    distance[next] = distance[inputPort] + 1;
+                    bfsQueue[tail++] = next;
+                }
+            }
+        }
+    }
+    return foundFree;
+}
+
+// DFS along the BFS layers for an augmenting path from inputPort
+inline bool MaxSizeScheduler::augment(const VoqBitmaps& occupied, int inputPort) {
+    const MaskWord* outputs = occupied.byInput(inputPort);
+    for (int w = 0; w < words; w++) {
+        MaskWord bits = outputs[w];
+        while (bits) {
+            int outputPort = (w << 6) + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            int next = matchedInput[outputPort];
+            if (next == -1 || (distance[next] == distance[inputPort] + 1 && augment(occupied, next))) {
+                accepted[inputPort] = outputPort;
+                matchedInput[outputPort] = inputPort;
+                return true;
+            }
+        }
+    }
+    // Dead end for the rest of this phase
+    distance[inputPort] = UNREACHED;
+    return false;
+}
+
+template <class Switch>
+void MaxSizeScheduler::processPackets(Switch& sw, int time) {
+    const VoqBitmaps& occupied = sw.occupied;
+    if (maskEmpty(occupied.activeInputs(), words)) {
+        return;
+    }
+    for (int port = 0; port < numPorts; port++) {
+        accepted[port] = -1;
+        matchedInput[port] = -1;
+    }
+
+    while (buildLayers(occupied)) {
+        for (int inputPort = 0; inputPort < numPorts; inputPort++) {
+            if (accepted[inputPort] == -1 && distance[inputPort] == 0) {
+                augment(occupied, inputPort);
+            }
+        }
+    }
+
+    transmitMatches(sw, time);
+}
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef HUNGARIAN_H
+#define HUNGARIAN_H
+
+#include <limits>
+#include <vector>
+
+// Maximum weight assignment on a dense size x size matrix (Kuhn-Munkres
+// with potentials, O(size^3)). Column potentials may be carried over from
+// a previous solve: any starting values are valid, and when the weights
+// change little between calls the old ones shorten the search.
+class AssignmentSolver {
+public:
+    // weight[row * size + col]; fills rowMatch[row] with its column
+    void solve(int size, const std::vector<long long>& weight, std::vector<long long>& colPotential, std::vector<int>& rowMatch) {
+        const long long INF = std::numeric_limits<long long>::max() / 4;
+        // 1-based as in the textbook formulation; column 0 is a sentinel
+        u.assign(size + 1, 0);
+        v.assign(size + 1, 0);
+        p.assign(size + 1, 0);
+        way.assign(size + 1, 0);
+        minv.resize(size + 1);
+        used.resize(size + 1);
+        for (int j = 1; j <= size; j++) {
+            v[j] = colPotential[j - 1];
+        }
+
+        for (int i = 1; i <= size; i++) {
+            p[0] = i;
+            int j0 = 0;
+            std::fill(minv.begin(), minv.end(), INF);
+            std::fill(used.begin(), used.end(), 0);
+            do {
+                used[j0] = 1;
+                int i0 = p[j0];
+                int j1 = 0;
+                long long delta = INF;
+                const long long* row = &weight[(size_t)(i0 - 1) * size];
+                for (int j = 1; j <= size; j++) {
+                    if (!used[j]) {
+                        // Minimising -weight maximises weight
+                        long long cur = -row[j - 1] - u[i0] - v[j];
+                        if (cur < minv[j]) {
+                            minv[j] = cur;
+                            way[j] = j0;
+                        }
+                        if (minv[j] < delta) {
+                            delta = minv[j];
+                            j1 = j;
+                        }
+                    }
+                }
+                for (int j = 0; j <= size; j++) {
+                    if (used[j]) {
+                        u[p[j]] += delta;
+                        v[j] -= delta;
+                    } else {
+                        minv[j] -= delta;
+                    }
+                }
+                j0 = j1;
+            } while (p[j0] != 0);
+            do {
+                int j1 = way[j0];
+                p[j0] = p[j1];
+                j0 = j1;
+            } while (j0);
+        }
+
+        rowMatch.assign(size, -1);
+        for (int j = 1; j <= size; j++) {
+            rowMatch[p[j] - 1] = j - 1;
+            colPotential[j - 1] = v[j];
+        }
+    }
+
+private:
+    std::vector<long long> u, v, minv;
+    std::vector<int> p, way;
+    std::vector<char> used;
+};
+
+#endif
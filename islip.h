@@ -0,0 +1,180 @@
+#ifndef ISLIP_H
+#define ISLIP_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "matching_scheduler.h"
+
+// iSLIP: request / grant / accept with round-robin grant and accept pointers.
+// Each slot runs up to maxIterations rounds; later rounds only consider ports
+// left unmatched by earlier ones. As in the iSLIP paper, pointers only move
+// when a grant is accepted in the first round. Requests and grants are port
+// bitmaps, so each arbitration is a round-robin pick over a few mask words.
+class IslipScheduler : public MatchingScheduler {
+public:
+    std::vector<int> grantPointer;
+    std::vector<int> acceptPointer;
+    int maxIterations; // 0 = until no new match is made
+
+    // Requests of the current slot: inputs requesting each output, words
+    // per output, and the outputs with at least one request
+    const MaskWord* requestMask = nullptr;
+    const MaskWord* activeOutputs = nullptr;
+
+    // Per-slot state as port bitmaps, kept to avoid allocating every slot
+    std::vector<MaskWord> grantMask; // Outputs granting each input, words per input
+    std::vector<int> grantedInputs;  // Inputs holding grants this round
+
+    // Iterations each slot needed before the matching stopped growing
+    std::vector<long long> convergenceHistogram;
+    long long busySlots = 0;
+    long long totalConvergenceIterations = 0;
+
+    explicit IslipScheduler(const SimConfig& config)
+        : MatchingScheduler(config),
+          grantPointer(numPorts, 0),
+          acceptPointer(numPorts, 0),
+          maxIterations(config.islipIterations),
+          grantMask(numPorts * words, 0),
+          convergenceHistogram(numPorts + 1, 0) {
+        grantedInputs.reserve(numPorts);
+    }
+
+    template <class Switch>
+    void processPackets(Switch& sw, int time);
+
+    // Matches the ports from the request bitmaps into accepted, recording
+    // requests, grants, accepts and pointer moves to events if given
+    void matchPorts(const MaskWord* requests, const MaskWord* active, EventTracer* events = nullptr);
+
+    void printStatistics(std::ostream& out) const;
+
+private:
+    template <bool Traced>
+    void runIterations(EventTracer* events);
+    template <bool Traced>
+    int runIteration(int iteration, EventTracer* events);
+    void traceRequests(EventTracer* events) const;
+};
+
+// One request/grant/accept round over the ports still unmatched; returns new matches
+template <bool Traced>
+inline int IslipScheduler::runIteration(int iteration, EventTracer* events) {
+    bool firstIteration = iteration == 0;
+    //grant phase: each free output picks the next free requesting input after its pointer
+    for (int w = 0; w < words; w++) {
+        MaskWord outputs = freeOutputs[w] & activeOutputs[w];
+        while (outputs) {
+            int outputPort = (w << 6) + __builtin_ctzll(outputs);
+            outputs &= outputs - 1;
+            int inputPort = roundRobinPick(&requestMask[outputPort * words], freeInputs.data(), words, grantPointer[outputPort]);
+            if (inputPort != -1) {
+                if (Traced) {
+                    events->record(EVENT_GRANT, inputPort, outputPort, 0, iteration);
+                }
+                MaskWord* grants = &grantMask[inputPort * words];
+                if (maskEmpty(grants, words)) {
+                    grantedInputs.push_back(inputPort);
+                }
+                setPort(grants, outputPort);
+            }
+        }
+    }
+    markPhase(PROFILE_GRANT);
+    //accept phase: each granted input picks the next granting output after its pointer
+    int newMatches = 0;
+    for (int inputPort : grantedInputs) {
+        MaskWord* grants = &grantMask[inputPort * words];
+        int outputPort = roundRobinPick(grants, freeOutputs.data(), words, acceptPointer[inputPort]);
+        clearMask(grants, words);
+        addMatch(inputPort, outputPort);
+        newMatches++;
+        if (firstIteration) {
+            acceptPointer[inputPort] = (outputPort + 1) % numPorts;
+            grantPointer[outputPort] = (inputPort + 1) % numPorts;
+        }
+        if (Traced) {
+            events->record(EVENT_ACCEPT, inputPort, outputPort, 0, iteration);
+            if (firstIteration) {
+                events->record(EVENT_POINTER, inputPort, outputPort, acceptPointer[inputPort], POINTER_ACCEPT);
+                events->record(EVENT_POINTER, inputPort, outputPort, grantPointer[outputPort], POINTER_GRANT);
+            }
+        }
+    }
+    grantedInputs.clear();
+    markPhase(PROFILE_ACCEPT);
+    return newMatches;
+}
+
+// Tracing is decided once per slot, so the untraced rounds are the plain
+// loops with no trace checks in them
+inline void IslipScheduler::matchPorts(const MaskWord* requests, const MaskWord* active, EventTracer* events) {
+    requestMask = requests;
+    activeOutputs = active;
+    resetMatching();
+    if (EVENT_TRACING && events) {
+        traceRequests(events);
+        markPhase(PROFILE_REQUEST);
+        runIterations<true>(events);
+    } else {
+        markPhase(PROFILE_REQUEST);
+        runIterations<false>(nullptr);
+    }
+}
+
+template <bool Traced>
+inline void IslipScheduler::runIterations(EventTracer* events) {
+    // A round that adds no match means the matching is maximal
+    int limit = maxIterations > 0 ? maxIterations : numPorts;
+    int iterations = 0;
+    for (int iteration = 0; iteration < limit; iteration++) {
+        if (runIteration<Traced>(iteration, events) == 0) {
+            break;
+        }
+        iterations = iteration + 1;
+    }
+    convergenceHistogram[iterations]++;
+    totalConvergenceIterations += iterations;
+    busySlots++;
+}
+
+// Every input requests the outputs it has cells for
+inline void IslipScheduler::traceRequests(EventTracer* events) const {
+    for (int w = 0; w < words; w++) {
+        for (MaskWord outputs = activeOutputs[w]; outputs; outputs &= outputs - 1) {
+            int outputPort = (w << 6) + __builtin_ctzll(outputs);
+            const MaskWord* inputs = &requestMask[outputPort * words];
+            for (int v = 0; v < words; v++) {
+                for (MaskWord bits = inputs[v]; bits; bits &= bits - 1) {
+                    events->record(EVENT_REQUEST, (v << 6) + __builtin_ctzll(bits), outputPort);
+                }
+            }
+        }
+    }
+}
+
+template <class Switch>
+void IslipScheduler::processPackets(Switch& sw, int time) {
+
+    //request phase: every non-empty VOQ requests its output
+    if (maskEmpty(sw.occupied.activeOutputs(), words)) {
+        return;
+    }
+    matchPorts(sw.occupied.outputMatrix(), sw.occupied.activeOutputs(), tracer);
+    transmitMatches(sw, time);
+}
+
+inline void IslipScheduler::printStatistics(std::ostream& out) const {
+    out << "iSLIP Iterations per Slot: " << (maxIterations > 0 ? std::to_string(maxIterations) : "until convergence") << std::endl;
+    out << "Average Iterations to Converge: " << (busySlots ? (double)totalConvergenceIterations / busySlots : 0) << std::endl;
+    out << "Iterations to Converge (slots): " << std::endl;
+    for (size_t n = 0; n < convergenceHistogram.size(); n++) {
+        if (convergenceHistogram[n]) {
+            out << n << ": " << convergenceHistogram[n] << std::endl;
+        }
+    }
+    out << "-----------------------------" << std::endl;
+}
+
+#endif
@@ -0,0 +1,136 @@
+// Microbenchmark: iSLIP grant/accept on port bitmaps against the original
+// scalar loops over a request matrix. Both run one iteration per slot on the
+// same pre-generated request snapshots and must produce the same matches.
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "islip.h"
+#include "sim_random.h"
+
+using namespace std;
+
+const int SNAPSHOTS = 64;
+
+// The scan-based iSLIP round from before the bitmap kernels
+struct ScalarIslip {
+    int numPorts;
+    vector<int> grantPointer;
+    vector<int> acceptPointer;
+    vector<int> granted;
+    vector<int> accepted;
+
+    explicit ScalarIslip(int numPorts)
+        : numPorts(numPorts), grantPointer(numPorts, 0), acceptPointer(numPorts, 0),
+          granted(numPorts, -1), accepted(numPorts, -1) {}
+
+    void match(const vector<char>& requests) {
+        for(int outputPort=0; outputPort<numPorts; outputPort++){
+            granted[outputPort]=-1;
+            accepted[outputPort]=-1;
+        }
+        //grant phase
+        for(int outputPort=0; outputPort<numPorts; outputPort++){
+            int grant=grantPointer[outputPort];
+            for(int i=grant; i<numPorts; i++){
+                if(requests[i*numPorts+outputPort]==1){
+                    granted[outputPort]=i;
+                    break;
+                }
+            }
+            if(granted[outputPort]==-1){
+                for(int i=0; i<grant; i++){
+                    if(requests[i*numPorts+outputPort]==1){
+                        granted[outputPort]=i;
+                        break;
+                    }
+                }
+            }
+        }
+        //accept phase
+        for(int inputPort=0; inputPort<numPorts; inputPort++){
+            int accept=acceptPointer[inputPort];
+            for(int n=0; n<numPorts; n++){
+                int i=accept+n<numPorts ? accept+n : accept+n-numPorts;
+                if(granted[i]==inputPort){
+                    accepted[inputPort]=i;
+                    acceptPointer[inputPort]=(i+1)%numPorts;
+                    grantPointer[i]=(inputPort+1)%numPorts;
+                    break;
+                }
+            }
+        }
+    }
+};
+
+// A snapshot's requests as the engine keeps them
+static VoqBitmaps toBitmaps(int n, const vector<char>& requests) {
+    VoqBitmaps bitmaps(n);
+    for (int inputPort = 0; inputPort < n; inputPort++) {
+        for (int outputPort = 0; outputPort < n; outputPort++) {
+            if (requests[inputPort * n + outputPort]) {
+                bitmaps.set(inputPort, outputPort);
+            }
+        }
+    }
+    return bitmaps;
+}
+
+template <class Fn>
+static double nsPerSlot(int slots, Fn fn) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int slot = 0; slot < slots; slot++) {
+        fn(slot);
+    }
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+    return chrono::duration<double, nano>(end - start).count() / slots;
+}
+
+int main() {
+    SimRandom random(RNG_XOSHIRO, 1);
+    const int portCounts[] = {8, 32, 128, 256, 512, 1024};
+    const double loads[] = {0.1, 0.5, 0.9};
+
+    cout << setw(6) << "ports" << setw(7) << "load" << setw(14) << "scalar ns" << setw(14) << "bitset ns" << setw(10) << "speedup" << endl;
+    for (int n : portCounts) {
+        for (double load : loads) {
+            SimConfig config;
+            config.numPorts = n;
+
+            // Snapshot s marks each VOQ busy with probability load
+            vector<vector<char>> snapshots(SNAPSHOTS, vector<char>(n * n));
+            vector<VoqBitmaps> bitmaps;
+            for (vector<char>& requests : snapshots) {
+                for (char& r : requests) {
+                    r = random.bernoulli(load);
+                }
+                bitmaps.push_back(toBitmaps(n, requests));
+            }
+
+            // Check both kernels agree on every snapshot
+            ScalarIslip scalar(n);
+            IslipScheduler bitset(config);
+            for (int s = 0; s < SNAPSHOTS; s++) {
+                scalar.match(snapshots[s]);
+                bitset.matchPorts(bitmaps[s].outputMatrix(), bitmaps[s].activeOutputs());
+                if (scalar.accepted != bitset.accepted) {
+                    cout << "Mismatch at " << n << " ports, load " << load << endl;
+                    return 1;
+                }
+            }
+
+            // The engine keeps the bitmaps current, so only the matching is timed
+            int slots = max(SNAPSHOTS, 20000000 / (n * n)) / SNAPSHOTS * SNAPSHOTS;
+            double scalarNs = nsPerSlot(slots, [&](int slot) { scalar.match(snapshots[slot % SNAPSHOTS]); });
+            double bitsetNs = nsPerSlot(slots, [&](int slot) {
+                const VoqBitmaps& requests = bitmaps[slot % SNAPSHOTS];
+                bitset.matchPorts(requests.outputMatrix(), requests.activeOutputs());
+            });
+
+            cout << setw(6) << n << setw(7) << load << fixed << setprecision(1)
+                 << setw(14) << scalarNs << setw(14) << bitsetNs
+                 << setw(9) << scalarNs / bitsetNs << "x" << defaultfloat << endl;
+        }
+    }
+    return 0;
+}
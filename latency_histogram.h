@@ -0,0 +1,114 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// HDR-style log-linear histogram of non-negative integer delays. Values
+// below 2 * SUB_BUCKETS get a bucket each; above that, every power of two
+// is split into SUB_BUCKETS equal buckets, so a bucket spans at most 1/32
+// of its values (about 3%) up to 2^31. Recording is a count-leading-zeros
+// and an increment into a fixed array; histograms merge by adding counts.
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 5;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static const int BUCKETS = (33 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+    LatencyHistogram() { clear(); }
+
+    void clear() {
+        memset(counts, 0, sizeof(counts));
+        valueSum = 0;
+        maximum = 0;
+    }
+
+    void record(int value) {
+        if (value < 0) {
+            value = 0;
+        }
+        counts[bucketOf((uint32_t)value)]++;
+        valueSum += value;
+        maximum = value > maximum ? value : maximum;
+    }
+
+    // Records value as if it were seen times times
+    void record(int value, uint64_t times) {
+        if (value < 0) {
+            value = 0;
+        }
+        counts[bucketOf((uint32_t)value)] += times;
+        valueSum += (long long)value * (long long)times;
+        maximum = value > maximum ? value : maximum;
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (int b = 0; b < BUCKETS; b++) {
+            counts[b] += other.counts[b];
+        }
+        valueSum += other.valueSum;
+        if (other.maximum > maximum) {
+            maximum = other.maximum;
+        }
+    }
+
+    uint64_t count() const {
+        uint64_t total = 0;
+        for (int b = 0; b < BUCKETS; b++) {
+            total += counts[b];
+        }
+        return total;
+    }
+    int max() const { return maximum; }
+    long long sum() const { return valueSum; }
+    double mean() const {
+        uint64_t total = count();
+        return total ? (double)valueSum / total : 0;
+    }
+
+    // Smallest recorded bucket holding at least a fraction q of the values,
+    // reported as its highest value (never above the maximum); 0 when empty
+    int percentile(double q) const {
+        uint64_t total = count();
+        if (total == 0) {
+            return 0;
+        }
+        uint64_t rank = (uint64_t)std::ceil(q * total);
+        rank = rank < 1 ? 1 : rank > total ? total : rank;
+        uint64_t seen = 0;
+        for (int b = 0; b < BUCKETS; b++) {
+            seen += counts[b];
+            if (seen >= rank) {
+                int highest = highestValue(b);
+                return highest < maximum ? highest : maximum;
+            }
+        }
+        return maximum;
+    }
+
+private:
+    // Branch-free: below 2 * SUB_BUCKETS the shift clamps to 0 and the
+    // value is its own bucket
+    static int bucketOf(uint32_t value) {
+        int shift = 31 - __builtin_clz(value | 1) - SUB_BUCKET_BITS;
+        shift = shift < 0 ? 0 : shift;
+        return shift * SUB_BUCKETS + (int)(value >> shift);
+    }
+
+    static int highestValue(int bucket) {
+        if (bucket < 2 * SUB_BUCKETS) {
+            return bucket;
+        }
+        int shift = (bucket >> SUB_BUCKET_BITS) - 1;
+        uint32_t lowest = (uint32_t)(bucket - shift * SUB_BUCKETS) << shift;
+        uint64_t highest = (uint64_t)lowest + ((uint64_t)1 << shift) - 1;
+        return highest > 0x7FFFFFFF ? 0x7FFFFFFF : (int)highest;
+    }
+
+    uint64_t counts[BUCKETS];
+    long long valueSum;
+    int maximum;
+};
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef LQF_APPROX_H
+#define LQF_APPROX_H
+
+#include <algorithm>
+#include <vector>
+#include "matching_scheduler.h"
+
+// Iterative longest queue first: iSLIP's request/grant/accept rounds, but
+// outputs grant and inputs accept the longest VOQ instead of following
+// round-robin pointers. A cheap approximation of LQF maximum weight matching.
+class IlqfScheduler : public MatchingScheduler {
+public:
+    int maxIterations; // 0 = until no new match is made
+
+    std::vector<int> grantedBy;     // Output granting each input this round, longest VOQ wins
+    std::vector<int> grantedInputs; // Inputs holding grants this round
+
+    explicit IlqfScheduler(const SimConfig& config)
+        : MatchingScheduler(config),
+          maxIterations(config.ilqfIterations),
+          grantedBy(numPorts, -1) {
+        grantedInputs.reserve(numPorts);
+    }
+
+    template <class Switch>
+    void processPackets(Switch& sw, int time);
+
+private:
+    template <class Switch>
+    int runIteration(const Switch& sw);
+};
+
+// One request/grant/accept round over the ports still unmatched; returns new matches
+template <class Switch>
+int IlqfScheduler::runIteration(const Switch& sw) {
+    const MaskWord* activeOutputs = sw.occupied.activeOutputs();
+    for (int w = 0; w < words; w++) {
+        MaskWord outputs = freeOutputs[w] & activeOutputs[w];
+        while (outputs) {
+            int outputPort = (w << 6) + __builtin_ctzll(outputs);
+            outputs &= outputs - 1;
+
+            //grant phase: the free input with the longest VOQ for this output
+            const MaskWord* requests = sw.occupied.byOutput(outputPort);
+            int inputPort = -1, longest = 0;
+            for (int v = 0; v < words; v++) {
+                MaskWord inputs = requests[v] & freeInputs[v];
+                while (inputs) {
+                    int candidate = (v << 6) + __builtin_ctzll(inputs);
+                    inputs &= inputs - 1;
+                    int length = sw.bufferOccupancy(candidate, outputPort);
+                    if (length > longest) {
+                        longest = length;
+                        inputPort = candidate;
+                    }
+                }
+            }
+            if (inputPort == -1) {
+                continue;
+            }
+
+            //accept phase, folded in: keep the grant with the longest VOQ
+            int current = grantedBy[inputPort];
+            if (current == -1) {
+                grantedInputs.push_back(inputPort);
+                grantedBy[inputPort] = outputPort;
+            } else if (longest > sw.bufferOccupancy(inputPort, current)) {
+                grantedBy[inputPort] = outputPort;
+            }
+        }
+    }
+    int newMatches = 0;
+    for (int inputPort : grantedInputs) {
+        addMatch(inputPort, grantedBy[inputPort]);
+        grantedBy[inputPort] = -1;
+        newMatches++;
+    }
+    grantedInputs.clear();
+    return newMatches;
+}
+
+template <class Switch>
+void IlqfScheduler::processPackets(Switch& sw, int time) {
+    if (maskEmpty(sw.occupied.activeOutputs(), words)) {
+        return;
+    }
+    resetMatching();
+    int limit = maxIterations > 0 ? maxIterations : numPorts;
+    for (int iteration = 0; iteration < limit; iteration++) {
+        if (runIteration(sw) == 0) {
+            break;
+        }
+    }
+    transmitMatches(sw, time);
+}
+
+// Greedy longest port first: inputs are visited from the most to the least
+// backlogged, and each takes the free output with the largest backlog among
+// its non-empty VOQs. Approximates LPF's port-occupancy weights in
+// O(N log N + E) per slot.
+class LpfScheduler : public MatchingScheduler {
+public:
+    std::vector<int> order;
+
+    explicit LpfScheduler(const SimConfig& config) : MatchingScheduler(config) {
+        order.reserve(numPorts);
+    }
+
+    template <class Switch>
+    void processPackets(Switch& sw, int time);
+};
+
+template <class Switch>
+void LpfScheduler::processPackets(Switch& sw, int time) {
+    const MaskWord* activeInputs = sw.occupied.activeInputs();
+    order.clear();
+    for (int w = 0; w < words; w++) {
+        for (MaskWord inputs = activeInputs[w]; inputs; inputs &= inputs - 1) {
+            order.push_back((w << 6) + __builtin_ctzll(inputs));
+        }
+    }
+    if (order.empty()) {
+        return;
+    }
+    const std::vector<int>& inputBacklog = sw.inputBacklog;
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return inputBacklog[a] > inputBacklog[b]; });
+
+    resetMatching();
+    for (int inputPort : order) {
+        const MaskWord* outputs = sw.occupied.byInput(inputPort);
+        int outputPort = -1, largest = -1;
+        for (int w = 0; w < words; w++) {
+            for (MaskWord bits = outputs[w] & freeOutputs[w]; bits; bits &= bits - 1) {
+                int candidate = (w << 6) + __builtin_ctzll(bits);
+                if (sw.outputBacklog[candidate] > largest) {
+                    largest = sw.outputBacklog[candidate];
+                    outputPort = candidate;
+                }
+            }
+        }
+        if (outputPort != -1) {
+            addMatch(inputPort, outputPort);
+        }
+    }
+    transmitMatches(sw, time);
+}
+
+#endif
@@ -0,0 +1,179 @@
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <ctime>
+#include "scheduler_registry.h"
+#include "sim_config.h"
+#include "sweep.h"
+#include "metrics_writer.h"
+#include "event_trace.h"
+#include "trace_file.h"
+
+using namespace std;
+
+static void printUsage(const char* program) {
+    cout << "Usage: " << program << " [options] <scheduler[,scheduler...]|all>" << endl;
+    cout << "Options:" << endl;
+    cout << "  --config FILE   Read \"key = value\" settings from FILE" << endl;
+    cout << "  --traffic T     uniform, non_uniform, bursty, bernoulli, poisson, on_off or trace (default uniform)" << endl;
+    cout << "  --burst_length B   Mean packets per burst of on_off traffic (default 16)" << endl;
+    cout << "  --trace_file FILE   Replay a binary trace made by trace_convert (sets --traffic trace)" << endl;
+    cout << "  --trace_slot_ns N   Trace nanoseconds per time slot (default 1000)" << endl;
+    cout << "  --destinations D   uniform, hotspot, diagonal, log_diagonal, unbalanced or file (default uniform)" << endl;
+    cout << "  --hotspots N    Hotspot outputs, ports 0 to N - 1 (default 1)" << endl;
+    cout << "  --hotspot_fraction F   Share of each input's packets sent to the hotspots (default 0.5)" << endl;
+    cout << "  --omega W       Share each input sends to its own output under unbalanced (default 0.5)" << endl;
+    cout << "  --destination_file FILE   numPorts x numPorts rate matrix, one row per input" << endl;
+    cout << "  --load L        Mean packets per input per slot, may be fractional (overrides --rate)" << endl;
+    cout << "  --seed N        Random seed, same for every scheduler (default: the clock)" << endl;
+    cout << "  --rng E         Random engine: xoshiro, pcg or philox (default xoshiro)" << endl;
+    cout << "  --ports N       Number of input and output ports (default 8)" << endl;
+    cout << "  --buffer N      Cells per VOQ (default 64)" << endl;
+    cout << "  --slots N       Time slots to simulate (default 1000)" << endl;
+    cout << "  --rate N        Packets arriving per input per slot (default 4)" << endl;
+    cout << "  --speedup S     Fabric scheduling phases per slot, may be fractional (default 1)" << endl;
+    cout << "  --cell_size N   Cut packets into cells of N size units, 0 = whole packets (default 0)" << endl;
+    cout << "  --packet_mode B    1 = hold each match until the whole packet has crossed (default 0)" << endl;
+    cout << "  --output_buffer N  Cells per output queue (default 64)" << endl;
+    cout << "  --drain R       Cells each output sends per slot (default 1.0)" << endl;
+    cout << "  --port_drain P:R   Line rate R for output port P only" << endl;
+    cout << "  --islip_iterations N  iSLIP rounds per slot, 0 = until convergence (default 1)" << endl;
+    cout << "  --pim_iterations N    PIM rounds per slot, 0 = until convergence (default 1)" << endl;
+    cout << "  --ilqf_iterations N   iLQF rounds per slot, 0 = until convergence (default 1)" << endl;
+    cout << "  --weights FILE  VOQ weights for drr/wfq, one row of numPorts weights per input" << endl;
+    cout << "  --quantum N     DRR credit per unit of weight per round (default 10)" << endl;
+    cout << "  --metrics_file FILE   Write interval metrics to FILE during the run (one file per scheduler)" << endl;
+    cout << "  --metrics_interval K  Slots per metrics row (default 1000)" << endl;
+    cout << "  --metrics_format F    csv or jsonl (default csv)" << endl;
+    cout << "  --metrics_voqs B      1 = add the cells queued in every VOQ to each row (default 0)" << endl;
+    cout << "  --profile B     1 = time each phase of the slot loop and print ns per slot (default 0)" << endl;
+    cout << "  --occupancy B   1 = track time-weighted buffer occupancy per input and VOQ (default 0)" << endl;
+    cout << "  --event_file FILE     Trace scheduling events to FILE; event_convert.exe turns it into Chrome/Perfetto JSON" << endl;
+    cout << "Sweeps (one CSV row per grid point, all run in this process):" << endl;
+    cout << "  --sweep KEY=V1,V2,...      Add an axis over the listed values of any setting" << endl;
+    cout << "  --sweep KEY=FIRST:LAST:STEP   Add an axis over a numeric range, e.g. load=0.1:1.0:0.1" << endl;
+    cout << "  --out FILE      Write the sweep rows to FILE instead of standard output" << endl;
+    cout << "  --threads N     Sweep worker threads (default: one per hardware thread)" << endl;
+    cout << "Schedulers:" << endl;
+    for (const SchedulerEntry& entry : schedulerRegistry()) {
+        cout << "  " << entry.name << "\t" << entry.description << endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    SimConfig config;
+    string names;
+    string outPath;
+    vector<SweepAxis> axes;
+    bool sweep = false;
+    string error;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.compare(0, 2, "--") != 0) {
+            names = arg;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            cout << "Missing value for " << arg << endl;
+            return 1;
+        }
+        string value = argv[++i];
+        bool ok = true;
+        if (arg == "--config") {
+            ok = loadConfigFile(config, value, error);
+        } else if (arg == "--sweep") {
+            axes.push_back(SweepAxis());
+            ok = parseSweepAxis(value, axes.back(), error);
+            sweep = true;
+        } else if (arg == "--out") {
+            outPath = value;
+            sweep = true;
+        } else {
+            ok = setConfigValue(config, arg.substr(2), value, error);
+        }
+        if (!ok) {
+            cout << "Error: " << error << endl;
+            return 1;
+        }
+    }
+    if (names.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    vector<const SchedulerEntry*> schedulers;
+    if (names == "all") {
+        for (const SchedulerEntry& entry : schedulerRegistry()) {
+            schedulers.push_back(&entry);
+        }
+    } else {
+        istringstream list(names);
+        string name;
+        while (getline(list, name, ',')) {
+            const SchedulerEntry* entry = findScheduler(name);
+            if (!entry) {
+                cout << "Unknown scheduler: " << name << endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+            schedulers.push_back(entry);
+        }
+    }
+    // A sweep checks and loads every point once its axes are applied; the
+    // base alone may not be valid (a load axis under bernoulli traffic)
+    if (!sweep && (!validateConfig(config, error) || !loadVoqWeights(config, error) ||
+                   !loadDestinationMatrix(config, error) || !loadTrace(config, error))) {
+        cout << "Error: " << error << endl;
+        return 1;
+    }
+
+    // Every scheduler sees the same seed so head-to-head runs share traffic
+    if (config.seed == 0) {
+        config.seed = (uint64_t)time(0);
+        bool seedAxis = false;
+        for (const SweepAxis& axis : axes) {
+            seedAxis = seedAxis || axis.key == "seed";
+        }
+        if (sweep && !seedAxis) {
+            // Standard output may be the CSV itself
+            cerr << "Seed: " << config.seed << " (from the clock)" << endl;
+        }
+    }
+
+    if (sweep) {
+        if (!config.metricsFile.empty() || !config.eventFile.empty()) {
+            cout << "Error: metrics_file and event_file cannot be used with a sweep" << endl;
+            return 1;
+        }
+        ofstream file;
+        if (!outPath.empty()) {
+            file.open(outPath);
+            if (!file) {
+                cout << "Error: cannot write '" << outPath << "'" << endl;
+                return 1;
+            }
+        }
+        if (!runSweep(config, schedulers, axes, outPath.empty() ? cout : file, error)) {
+            cout << "Error: " << error << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    cout << "Traffic: " << trafficName(config.traffic) << ", seed " << config.seed << ", rng " << rngName(config.rng) << endl;
+    for (const SchedulerEntry* entry : schedulers) {
+        cout << "Scheduler: " << entry->name << endl;
+        string tag = schedulers.size() > 1 ? entry->name : "";
+        if (!openMetrics(config, tag, error) || !openEvents(config, tag, error)) {
+            cout << "Error: " << error << endl;
+            return 1;
+        }
+        entry->run(config, &cout);
+        if ((config.metrics && !config.metrics->close(error)) || (config.events && !config.events->close(error))) {
+            cout << "Error: " << error << endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,53 @@
+#ifndef MATCHING_SCHEDULER_H
+#define MATCHING_SCHEDULER_H
+
+#include <vector>
+#include "port_mask.h"
+#include "router_switch.h"
+
+// Base for schedulers that compute an input-output matching from the
+// engine's VOQ bitmaps every slot and then send one packet per match
+class MatchingScheduler : public SchedulerBase {
+public:
+    int words; // Mask words per port set
+
+    std::vector<int> accepted;        // Output matched to each input this slot, -1 if none
+    std::vector<MaskWord> freeInputs; // Ports not matched yet this slot
+    std::vector<MaskWord> freeOutputs;
+
+    explicit MatchingScheduler(const SimConfig& config)
+        : SchedulerBase(config),
+          words(maskWords(numPorts)),
+          accepted(numPorts, -1),
+          freeInputs(words, 0),
+          freeOutputs(words, 0) {}
+
+    void resetMatching() {
+        fillMask(freeInputs.data(), numPorts);
+        fillMask(freeOutputs.data(), numPorts);
+        for (int inputPort = 0; inputPort < numPorts; inputPort++) {
+            accepted[inputPort] = -1;
+        }
+    }
+
+    void addMatch(int inputPort, int outputPort) {
+        accepted[inputPort] = outputPort;
+        clearPort(freeInputs.data(), inputPort);
+        clearPort(freeOutputs.data(), outputPort);
+    }
+
+    // Send the highest priority packet of every matched VOQ
+    template <class Switch>
+    void transmitMatches(Switch& sw, int time) {
+        markPhase(PROFILE_MATCH);
+        for (int inputPort = 0; inputPort < numPorts; inputPort++) {
+            if (accepted[inputPort] != -1) {
+                int outputPort = accepted[inputPort];
+                sw.transmit(inputPort, outputPort, sw.highestClass(inputPort, outputPort), time);
+            }
+        }
+        markPhase(PROFILE_DEQUEUE);
+    }
+};
+
+#endif
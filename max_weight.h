@@ -0,0 +1,93 @@
+#ifndef MAX_WEIGHT_H
+#define MAX_WEIGHT_H
+
+#include <vector>
+#include "hungarian.h"
+#include "matching_scheduler.h"
+
+// Maximum weight matching, the throughput-optimal reference. Each non-empty
+// VOQ is weighted by its length (LQF) or by the age of its oldest head
+// packet (OCF), and the heaviest matching is found exactly. Only busy
+// inputs and outputs enter the assignment, and the solver keeps each
+// output's potential from the previous slot as a warm start.
+template <bool OldestCellFirst>
+class MaxWeightScheduler : public MatchingScheduler {
+public:
+    std::vector<int> rows; // Busy inputs this slot
+    std::vector<int> cols; // Busy outputs this slot
+    std::vector<long long> weight;
+    std::vector<long long> colPotential;
+    std::vector<long long> outputPotential; // Warm start, per output port
+    std::vector<int> rowMatch;
+    AssignmentSolver solver;
+
+    explicit MaxWeightScheduler(const SimConfig& config)
+        : MatchingScheduler(config),
+          outputPotential(numPorts, 0) {
+        rows.reserve(numPorts);
+        cols.reserve(numPorts);
+    }
+
+    template <class Switch>
+    void processPackets(Switch& sw, int time);
+};
+
+template <bool OldestCellFirst>
+template <class Switch>
+void MaxWeightScheduler<OldestCellFirst>::processPackets(Switch& sw, int time) {
+    rows.clear();
+    cols.clear();
+    for (int port = 0; port < numPorts; port++) {
+        if (testPort(sw.occupied.activeInputs(), port)) {
+            rows.push_back(port);
+        }
+        if (testPort(sw.occupied.activeOutputs(), port)) {
+            cols.push_back(port);
+        }
+    }
+    if (rows.empty()) {
+        return;
+    }
+
+    // Pad to a square matrix; padding and empty VOQs weigh nothing
+    int size = rows.size() > cols.size() ? rows.size() : cols.size();
+    weight.assign((size_t)size * size, 0);
+    colPotential.assign(size, 0);
+    for (size_t c = 0; c < cols.size(); c++) {
+        colPotential[c] = outputPotential[cols[c]];
+    }
+    for (size_t r = 0; r < rows.size(); r++) {
+        const MaskWord* outputs = sw.occupied.byInput(rows[r]);
+        for (size_t c = 0; c < cols.size(); c++) {
+            if (testPort(outputs, cols[c])) {
+                weight[r * size + c] = OldestCellFirst ? time - sw.oldestArrivalTime(rows[r], cols[c]) + 1
+                                                       : sw.bufferOccupancy(rows[r], cols[c]);
+            }
+        }
+    }
+
+    solver.solve(size, weight, colPotential, rowMatch);
+
+    // Shifting every potential by the same amount keeps them valid and bounded
+    long long highest = colPotential[0];
+    for (int c = 1; c < size; c++) {
+        highest = colPotential[c] > highest ? colPotential[c] : highest;
+    }
+    for (size_t c = 0; c < cols.size(); c++) {
+        outputPotential[cols[c]] = colPotential[c] - highest;
+    }
+
+    resetMatching();
+    for (size_t r = 0; r < rows.size(); r++) {
+        int c = rowMatch[r];
+        if (c < (int)cols.size() && weight[r * size + c] > 0) {
+            addMatch(rows[r], cols[c]);
+        }
+    }
+    transmitMatches(sw, time);
+}
+
+typedef MaxWeightScheduler<false> LqfScheduler;
+typedef MaxWeightScheduler<true> OcfScheduler;
+
+#endif
@@ -0,0 +1,89 @@
+#include "metrics_writer.h"
+
+using namespace std;
+
+static const size_t BUFFER_BYTES = 1 << 16;
+
+MetricsWriter::~MetricsWriter() {
+    if (file) {
+        flush();
+        fclose(file);
+    }
+}
+
+bool MetricsWriter::open(const string& path, MetricsFormat format, string& error) {
+    file = fopen(path.c_str(), "wb");
+    if (!file) {
+        error = "cannot write '" + path + "'";
+        return false;
+    }
+    this->format = format;
+    buffer.assign(BUFFER_BYTES, 0);
+    used = 0;
+    failed = false;
+    started = false;
+    columns.clear();
+    return true;
+}
+
+void MetricsWriter::addColumn(const string& name, int count) {
+    Column added;
+    added.name = name;
+    added.count = count;
+    if (format == METRICS_JSONL) {
+        added.prefix = (columns.empty() ? "\"" : ",\"") + name + "\":" + (count != 1 ? "[" : "");
+    } else {
+        added.prefix = columns.empty() ? "" : ",";
+    }
+    columns.push_back(added);
+}
+
+void MetricsWriter::writeHeader() {
+    started = true;
+    if (format != METRICS_CSV) {
+        return;
+    }
+    string header;
+    for (const Column& c : columns) {
+        for (int k = 0; k < c.count; k++) {
+            header += (header.empty() ? "" : ",") + c.name;
+            if (c.count != 1) {
+                header += "_" + to_string(k);
+            }
+        }
+    }
+    header += '\n';
+    flush();
+    failed = fwrite(header.data(), 1, header.size(), file) != header.size() || failed;
+}
+
+void MetricsWriter::flush() {
+    if (used > 0 && fwrite(buffer.data(), 1, used, file) != used) {
+        failed = true;
+    }
+    used = 0;
+}
+
+bool MetricsWriter::close(string& error) {
+    flush();
+    bool ok = !failed && !ferror(file);
+    ok = fclose(file) == 0 && ok;
+    file = nullptr;
+    if (!ok) {
+        error = "error writing the metrics";
+    }
+    return ok;
+}
+
+bool openMetrics(SimConfig& config, const string& tag, string& error) {
+    config.metrics.reset();
+    if (config.metricsFile.empty()) {
+        return true;
+    }
+    shared_ptr<MetricsWriter> metrics(new MetricsWriter());
+    if (!metrics->open(taggedPath(config.metricsFile, tag), config.metricsFormat, error)) {
+        return false;
+    }
+    config.metrics = metrics;
+    return true;
+}
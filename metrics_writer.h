@@ -0,0 +1,122 @@
+#ifndef METRICS_WRITER_H
+#define METRICS_WRITER_H
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "sim_config.h"
+
+// Time series of interval snapshots, one CSV row or one JSON object per
+// line. Columns are declared once before the first row; rows then write
+// their values in column order straight into a fixed buffer, which goes to
+// the file in large writes. A row allocates nothing and flushes nothing.
+class MetricsWriter {
+public:
+    MetricsWriter() {}
+    ~MetricsWriter();
+    MetricsWriter(const MetricsWriter&) = delete;
+    MetricsWriter& operator=(const MetricsWriter&) = delete;
+
+    bool open(const std::string& path, MetricsFormat format, std::string& error);
+    // A group of count values is one JSON array, or CSV columns name_0 ...
+    void addColumn(const std::string& name, int count = 1);
+
+    void beginRow() {
+        if (!started) {
+            writeHeader();
+        }
+        reserve(2);
+        if (format == METRICS_JSONL) {
+            buffer[used++] = '{';
+        }
+        column = 0;
+        item = 0;
+    }
+    void put(long long value) {
+        separate();
+        char digits[24];
+        int length = 0;
+        unsigned long long magnitude = value < 0 ? 0 - (unsigned long long)value : (unsigned long long)value;
+        do {
+            digits[length++] = (char)('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude);
+        if (value < 0) {
+            buffer[used++] = '-';
+        }
+        while (length > 0) {
+            buffer[used++] = digits[--length];
+        }
+        advance();
+    }
+    void put(int value) { put((long long)value); }
+    void put(double value) {
+        separate();
+        used += snprintf(&buffer[used], 32, "%.6g", value);
+        advance();
+    }
+    void endRow() {
+        reserve(2);
+        if (format == METRICS_JSONL) {
+            buffer[used++] = '}';
+        }
+        buffer[used++] = '\n';
+    }
+
+    // Writes what is buffered and closes the file; false and error if any
+    // write failed
+    bool close(std::string& error);
+
+private:
+    // Room for a value with its separator and key
+    void separate() {
+        const Column& current = columns[column];
+        reserve(current.prefix.size() + 32);
+        if (item == 0) {
+            memcpy(&buffer[used], current.prefix.data(), current.prefix.size());
+            used += current.prefix.size();
+        } else {
+            buffer[used++] = ',';
+        }
+    }
+    void advance() {
+        if (++item == columns[column].count) {
+            if (format == METRICS_JSONL && columns[column].count != 1) {
+                buffer[used++] = ']';
+            }
+            column++;
+            item = 0;
+        }
+    }
+    void reserve(size_t bytes) {
+        if (used + bytes > buffer.size()) {
+            flush();
+        }
+    }
+    void flush();
+    void writeHeader();
+
+    struct Column {
+        std::string name;
+        int count;
+        std::string prefix; // Separator and JSON key written before its first value
+    };
+
+    FILE* file = nullptr;
+    MetricsFormat format = METRICS_CSV;
+    std::vector<char> buffer;
+    size_t used = 0;
+    bool failed = false;
+    bool started = false; // Header written
+    std::vector<Column> columns;
+    size_t column = 0; // Position within the current row
+    int item = 0;
+};
+
+// Opens config.metricsFile into config.metrics, or clears it when no file
+// is set. A non-empty tag goes into the file name ahead of its extension,
+// so runs of several schedulers write "metrics.islip.csv" and so on.
+bool openMetrics(SimConfig& config, const std::string& tag, std::string& error);
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef OCCUPANCY_TRACKER_H
+#define OCCUPANCY_TRACKER_H
+
+#include <vector>
+#include "latency_histogram.h"
+
+// Time-weighted occupancy of a set of queues, as if every queue were
+// sampled at the end of each slot, without any per-slot work. A queue
+// remembers the slot its level last changed; the next change charges the
+// old level for the slots in between, so an update costs O(1) however
+// many queues sit idle. Levels that only last part of a slot never reach
+// the histograms, but do count towards the peak, the high-water mark a
+// buffer has to hold.
+class OccupancyTracker {
+public:
+    // perQueueHistograms keeps one histogram per queue, otherwise one
+    // histogram pools every queue's slots
+    OccupancyTracker(int queues, bool perQueueHistograms)
+        : levels(queues), histograms(perQueueHistograms ? queues : 1), perQueue(perQueueHistograms) {}
+
+    void update(int queue, int level, int slot) {
+        Level& q = levels[queue];
+        settle(queue, q, slot);
+        q.level = level;
+        q.peak = level > q.peak ? level : q.peak;
+    }
+
+    // Charges every queue up to the end of the run; call once it is over
+    void finish(int slots) {
+        for (size_t k = 0; k < levels.size(); k++) {
+            settle((int)k, levels[k], slots);
+        }
+    }
+
+    int size() const { return (int)levels.size(); }
+    int peak(int queue) const { return levels[queue].peak; }
+    // Cells held per slot, once finish() has run
+    double mean(int queue, int slots) const { return slots > 0 ? (double)levels[queue].area / slots : 0; }
+    const LatencyHistogram& histogram(int queue) const { return histograms[perQueue ? queue : 0]; }
+    LatencyHistogram pooled() const {
+        LatencyHistogram all;
+        for (const LatencyHistogram& h : histograms) {
+            all.merge(h);
+        }
+        return all;
+    }
+
+private:
+    struct Level {
+        long long area = 0; // Level summed over the settled slots
+        int level = 0;
+        int since = 0;      // First slot not yet charged
+        int peak = 0;
+    };
+
+    void settle(int queue, Level& q, int slot) {
+        int slots = slot - q.since;
+        if (slots > 0) {
+            q.area += (long long)q.level * slots;
+            histograms[perQueue ? queue : 0].record(q.level, (uint64_t)slots);
+            q.since = slot;
+        }
+    }
+
+    std::vector<Level> levels;
+    std::vector<LatencyHistogram> histograms;
+    bool perQueue;
+};
+
+#endif
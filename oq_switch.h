@@ -0,0 +1,19 @@
+#ifndef OQ_SWITCH_H
+#define OQ_SWITCH_H
+
+#include "router_switch.h"
+
+// Ideal output-queued switch used as a reference point: every arriving
+// packet is written straight into its output queue, so only the egress
+// buffers and line rates limit it
+class OutputQueuedScheduler : public SchedulerBase {
+public:
+    static const bool outputQueued = true;
+
+    explicit OutputQueuedScheduler(const SimConfig& config) : SchedulerBase(config) {}
+
+    template <class Switch>
+    void processPackets(Switch& sw, int time) {}
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef OUTPUT_BUFFER_H
+#define OUTPUT_BUFFER_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "voq_buffer.h"
+
+// Finite egress queues, one fixed-size ring per output port in a single
+// arena. Entries are whole packets, each taking one or more cells of the
+// port's capacity. Each port drains at its own line rate, given in cells
+// per slot; fractional rates accumulate credit across slots, and a packet
+// departs with its last cell.
+class OutputBuffers {
+public:
+    OutputBuffers(int numPorts, int capacity, const std::vector<double>& drainRate)
+        : capacity(capacity),
+          drainRate(drainRate),
+          credit(numPorts, 0.0),
+          head(numPorts, 0),
+          count(numPorts, 0),
+          cellsQueued(numPorts, 0),
+          headSent(numPorts, 0),
+          packets(new Cell[(size_t)numPorts * capacity]),
+          lengths(new uint16_t[(size_t)numPorts * capacity]) {}
+
+    // Cells queued at the port
+    int size(int port) const { return cellsQueued[port]; }
+    bool full(int port, int cells = 1) const { return cellsQueued[port] + cells > capacity; }
+
+    // Caller checks full() first; cells is the packet's length
+    void push(int port, const Cell& packet, int cells = 1) {
+        int slot = head[port] + count[port];
+        if (slot >= capacity) {
+            slot -= capacity;
+        }
+        packets[(size_t)port * capacity + slot] = packet;
+        lengths[(size_t)port * capacity + slot] = (uint16_t)cells;
+        count[port]++;
+        cellsQueued[port] += cells;
+    }
+
+    // Send up to the port's line rate this slot; visit(packet) sees each
+    // packet whose last cell leaves. Returns the cells sent.
+    template <class Visitor>
+    int drain(int port, Visitor visit) {
+        credit[port] += drainRate[port];
+        int sent = 0;
+        while (credit[port] >= 1.0 && count[port] > 0) {
+            size_t slot = (size_t)port * capacity + head[port];
+            credit[port] -= 1.0;
+            cellsQueued[port]--;
+            sent++;
+            if (++headSent[port] == lengths[slot]) {
+                visit(packets[slot]);
+                headSent[port] = 0;
+                head[port] = head[port] + 1 == capacity ? 0 : head[port] + 1;
+                count[port]--;
+            }
+        }
+        // An idle line cannot bank bandwidth for later
+        if (count[port] == 0) {
+            credit[port] = 0.0;
+        }
+        return sent;
+    }
+
+private:
+    int capacity;
+    std::vector<double> drainRate;
+    std::vector<double> credit;
+    std::vector<int> head;
+    std::vector<int> count;       // Packets queued
+    std::vector<int> cellsQueued;
+    std::vector<int> headSent;    // Cells of the head packet already sent
+    std::unique_ptr<Cell[]> packets;
+    std::unique_ptr<uint16_t[]> lengths;
+};
+
+#endif
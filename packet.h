@@ -0,0 +1,15 @@
+#ifndef PACKET_H
+#define PACKET_H
+
+const int NUM_CLASSES = 3; // Traffic classes (priorities 1..3)
+
+// Define a structure for a Packet
+struct Packet {
+    int priority; // Priority of the packet (lower number = higher priority)
+    int arrivalTime;
+    int processingTime;
+    int outputPort;
+    int size;
+};
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef PENDING_MATCHER_H
+#define PENDING_MATCHER_H
+
+#include <queue>
+#include <vector>
+#include "router_switch.h"
+
+// Greedy matcher shared by the RR, priority and WFQ schedulers. Each output
+// port keeps a FIFO of input ports that have packets for it; an output is
+// matched to the input at the head of its FIFO if that input is still free.
+// An input is listed at most once per output, so a FIFO never holds more
+// than numPorts entries however long the switch is overloaded.
+class PendingInputMatcher : public SchedulerBase {
+public:
+    std::vector<std::queue<int>> pendingInputPorts;
+    std::vector<char> queued; // Per VOQ, indexed input * numPorts + output: input is in the output's FIFO
+
+    std::vector<int> inputPortCorrespondingToOutputPort;
+    std::vector<int> outputPortCorrespondingToInputPort;
+
+    explicit PendingInputMatcher(const SimConfig& config)
+        : SchedulerBase(config),
+          pendingInputPorts(numPorts),
+          queued(numPorts * numPorts, 0),
+          inputPortCorrespondingToOutputPort(numPorts, -1),
+          outputPortCorrespondingToInputPort(numPorts, -1) {}
+
+    // An input joins the output's FIFO when it gets packets for it and is not listed yet
+    void onEnqueue(int inputPort, int outputPort, int time) {
+        if (requeue(inputPort, outputPort)) {
+            if (EVENT_TRACING && tracer) {
+                tracer->record(EVENT_REQUEST, inputPort, outputPort);
+            }
+        }
+    }
+
+    // Lists the input at the back of the output's FIFO unless it is there
+    // already; false if it was
+    bool requeue(int inputPort, int outputPort) {
+        char& listed = queued[inputPort * numPorts + outputPort];
+        if (listed) {
+            return false;
+        }
+        listed = 1;
+        pendingInputPorts[outputPort].push(inputPort);
+        return true;
+    }
+
+    // Ports busy with a packet-mode packet are passed over, and their
+    // inputs keep their place in the FIFOs. Each output grants the input at
+    // the head of its FIFO, which accepts if it is still free.
+    template <class Switch>
+    void matchPendingInputs(const Switch& sw) {
+        if (EVENT_TRACING && tracer) {
+            matchPending<true>(sw);
+        } else {
+            matchPending<false>(sw);
+        }
+        markPhase(PROFILE_MATCH);
+    }
+
+private:
+    template <bool Traced, class Switch>
+    void matchPending(const Switch& sw) {
+        for (int port = 0; port < numPorts; port++) {
+            inputPortCorrespondingToOutputPort[port] = -1;
+            outputPortCorrespondingToInputPort[port] = -1;
+        }
+
+        //input port priority order = 1,2,3,4,5,6,7,8
+        //output port priority order= 1,2,3,4,5,6,7,8
+        for(int outputPort=0; outputPort<numPorts; outputPort++)
+        {
+            if(!pendingInputPorts[outputPort].empty() && !sw.outputBusy(outputPort)){
+                int candidate=pendingInputPorts[outputPort].front();
+                if (Traced) {
+                    tracer->record(EVENT_GRANT, candidate, outputPort);
+                }
+                if(outputPortCorrespondingToInputPort[candidate]==-1 && !sw.inputBusy(candidate)){
+                    inputPortCorrespondingToOutputPort[outputPort]=candidate;
+                    outputPortCorrespondingToInputPort[candidate]=outputPort;
+                    pendingInputPorts[outputPort].pop();
+                    queued[candidate * numPorts + outputPort] = 0;
+                    if (Traced) {
+                        tracer->record(EVENT_ACCEPT, candidate, outputPort);
+                    }
+                }
+            }
+        }
+    }
+};
+
+#endif
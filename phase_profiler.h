@@ -0,0 +1,104 @@
+#ifndef PHASE_PROFILER_H
+#define PHASE_PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Parts of the slot loop that run time is split into. Schedulers that do
+// not break their decision down report it all as match; DRR and WF2Q+ pick
+// and send packet by packet, so their dequeues count as match too.
+enum ProfilePhase {
+    PROFILE_GENERATE = 0, // Traffic generation and admission into the VOQs
+    PROFILE_REQUEST,      // Building the requests of a matching round
+    PROFILE_GRANT,
+    PROFILE_ACCEPT,
+    PROFILE_MATCH,        // The rest of the scheduling decision
+    PROFILE_DEQUEUE,      // Cells leaving the VOQs across the fabric
+    PROFILE_DRAIN,        // Output queues sending on their links
+    PROFILE_STATS,        // Interval metrics rows
+    PROFILE_PHASES
+};
+
+inline const char* profilePhaseName(int phase) {
+    static const char* const names[PROFILE_PHASES] = {"generate", "request", "grant", "accept",
+                                                      "match", "dequeue", "drain", "stats"};
+    return phase >= 0 && phase < PROFILE_PHASES ? names[phase] : "unknown";
+}
+
+// Splits the wall time of a run among the phases of the slot loop. Every
+// mark() reads the time stamp counter once and charges the ticks since the
+// previous mark to a phase, so a slot costs a handful of counter reads.
+// Ticks are turned into nanoseconds at the end, against steady_clock over
+// the whole run, so the counter needs no calibration pause.
+class PhaseProfiler {
+public:
+    PhaseProfiler() {
+        for (uint64_t& t : ticks) {
+            t = 0;
+        }
+    }
+
+    void start() {
+        startTime = std::chrono::steady_clock::now();
+        startTicks = readTicks();
+        last = startTicks;
+    }
+
+    void mark(ProfilePhase phase) {
+        uint64_t now = readTicks();
+        ticks[phase] += now - last;
+        last = now;
+    }
+
+    void stop() {
+        double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count();
+        uint64_t counted = readTicks() - startTicks;
+        nanosPerTick = counted > 0 ? elapsed / counted : 0;
+    }
+
+    double nanos(int phase) const { return ticks[phase] * nanosPerTick; }
+    double totalNanos() const {
+        double total = 0;
+        for (int p = 0; p < PROFILE_PHASES; p++) {
+            total += nanos(p);
+        }
+        return total;
+    }
+
+    void print(std::ostream& out, int slots) const {
+        double total = totalNanos();
+        std::streamsize precision = out.precision();
+        out << "Time per Slot by Phase: " << std::endl;
+        for (int p = 0; p < PROFILE_PHASES; p++) {
+            out << profilePhaseName(p) << ": " << std::fixed << std::setprecision(1)
+                << (slots > 0 ? nanos(p) / slots : 0) << " ns (" << (total > 0 ? 100 * nanos(p) / total : 0) << "%)"
+                << std::defaultfloat << std::endl;
+        }
+        out << "total: " << std::fixed << std::setprecision(1) << (slots > 0 ? total / slots : 0) << " ns"
+            << std::defaultfloat << std::setprecision(precision) << std::endl;
+        out << "-----------------------------" << std::endl;
+    }
+
+private:
+    static uint64_t readTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    uint64_t ticks[PROFILE_PHASES];
+    uint64_t startTicks = 0;
+    uint64_t last = 0;
+    std::chrono::steady_clock::time_point startTime;
+    double nanosPerTick = 0;
+};
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef PIM_H
+#define PIM_H
+
+#include <vector>
+#include "matching_scheduler.h"
+#include "sim_random.h"
+
+// Parallel Iterative Matching: like iSLIP, but outputs grant and inputs
+// accept uniformly at random instead of from round-robin pointers
+class PimScheduler : public MatchingScheduler {
+public:
+    int maxIterations; // 0 = until no new match is made
+    SimRandom random;
+
+    std::vector<MaskWord> grantMask; // Outputs granting each input, words per input
+    std::vector<int> grantedInputs;  // Inputs holding grants this round
+
+    explicit PimScheduler(const SimConfig& config)
+        : MatchingScheduler(config),
+          maxIterations(config.pimIterations),
+          random(config.rng, SimRandom::streamSeed(config.seed, STREAM_SCHEDULER)),
+          grantMask(numPorts * words, 0) {
+        grantedInputs.reserve(numPorts);
+    }
+
+    template <class Switch>
+    void processPackets(Switch& sw, int time);
+
+private:
+    int runIteration(const MaskWord* requests, const MaskWord* activeOutputs);
+};
+
+// One request/grant/accept round over the ports still unmatched; returns new matches
+inline int PimScheduler::runIteration(const MaskWord* requests, const MaskWord* activeOutputs) {
+    //grant phase: each free output grants a random free requesting input
+    for (int w = 0; w < words; w++) {
+        MaskWord outputs = freeOutputs[w] & activeOutputs[w];
+        while (outputs) {
+            int outputPort = (w << 6) + __builtin_ctzll(outputs);
+            outputs &= outputs - 1;
+            const MaskWord* row = &requests[outputPort * words];
+            int candidates = countPorts(row, freeInputs.data(), words);
+            if (candidates == 0) {
+                continue;
+            }
+            int inputPort = nthPort(row, freeInputs.data(), words, random.uniformInt(candidates));
+            MaskWord* grants = &grantMask[inputPort * words];
+            if (maskEmpty(grants, words)) {
+                grantedInputs.push_back(inputPort);
+            }
+            setPort(grants, outputPort);
+        }
+    }
+    markPhase(PROFILE_GRANT);
+    //accept phase: each granted input accepts a random grant
+    int newMatches = 0;
+    for (int inputPort : grantedInputs) {
+        MaskWord* grants = &grantMask[inputPort * words];
+        int candidates = countPorts(grants, freeOutputs.data(), words);
+        int outputPort = nthPort(grants, freeOutputs.data(), words, random.uniformInt(candidates));
+        clearMask(grants, words);
+        addMatch(inputPort, outputPort);
+        newMatches++;
+    }
+    grantedInputs.clear();
+    markPhase(PROFILE_ACCEPT);
+    return newMatches;
+}
+
+template <class Switch>
+void PimScheduler::processPackets(Switch& sw, int time) {
+    if (maskEmpty(sw.occupied.activeOutputs(), words)) {
+        return;
+    }
+    resetMatching();
+    markPhase(PROFILE_REQUEST);
+    int limit = maxIterations > 0 ? maxIterations : numPorts;
+    for (int iteration = 0; iteration < limit; iteration++) {
+        if (runIteration(sw.occupied.outputMatrix(), sw.occupied.activeOutputs()) == 0) {
+            break;
+        }
+    }
+    transmitMatches(sw, time);
+}
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef PORT_MASK_H
+#define PORT_MASK_H
+
+#include <cstdint>
+#include <cstring>
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+// Sets of ports as packed bitmaps: bit p of word p / 64 is port p. A switch
+// with N ports uses maskWords(N) words per set, so one 512-port set is 8 words.
+typedef uint64_t MaskWord;
+
+inline int maskWords(int numPorts) { return (numPorts + 63) / 64; }
+
+inline bool testPort(const MaskWord* mask, int port) { return (mask[port >> 6] >> (port & 63)) & 1; }
+inline void setPort(MaskWord* mask, int port) { mask[port >> 6] |= (MaskWord)1 << (port & 63); }
+inline void clearPort(MaskWord* mask, int port) { mask[port >> 6] &= ~((MaskWord)1 << (port & 63)); }
+inline void clearMask(MaskWord* mask, int words) { memset(mask, 0, words * sizeof(MaskWord)); }
+
+inline void fillMask(MaskWord* mask, int numPorts) {
+    int words = maskWords(numPorts);
+    memset(mask, 0xFF, words * sizeof(MaskWord));
+    if (numPorts & 63) {
+        mask[words - 1] = ((MaskWord)1 << (numPorts & 63)) - 1;
+    }
+}
+
+inline bool maskEmpty(const MaskWord* mask, int words) {
+    for (int w = 0; w < words; w++) {
+        if (mask[w]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// First word index in [from, to) where a & b is non-zero, or to if none.
+// Wide switches skip empty stretches four or eight words at a time.
+inline int firstNonZeroWord(const MaskWord* a, const MaskWord* b, int from, int to) {
+    int w = from;
+#if defined(__AVX512F__)
+    for (; w + 8 <= to; w += 8) {
+        __m512i va = _mm512_loadu_si512((const void*)(a + w));
+        __m512i vb = _mm512_loadu_si512((const void*)(b + w));
+        if (_mm512_test_epi64_mask(va, vb)) {
+            break;
+        }
+    }
+#endif
+#if defined(__AVX2__)
+    for (; w + 4 <= to; w += 4) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + w));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + w));
+        if (!_mm256_testz_si256(va, vb)) {
+            break;
+        }
+    }
+#endif
+    for (; w < to; w++) {
+        if (a[w] & b[w]) {
+            return w;
+        }
+    }
+    return to;
+}
+
+// Round-robin arbiter: the first port p >= start (wrapping round to 0) that
+// is set in both a and b, or -1 if a & b is empty. Costs a rotate and a
+// find-first-set per word instead of a scan over every port.
+inline int roundRobinPick(const MaskWord* a, const MaskWord* b, int words, int start) {
+    int startWord = start >> 6;
+    int startBit = start & 63;
+
+    // Ports at or after start in the starting word
+    MaskWord bits = (a[startWord] & b[startWord]) >> startBit;
+    if (bits) {
+        return start + __builtin_ctzll(bits);
+    }
+    int w = firstNonZeroWord(a, b, startWord + 1, words);
+    if (w < words) {
+        return (w << 6) + __builtin_ctzll(a[w] & b[w]);
+    }
+    // Wrap round to port 0, ending with the ports below start in the starting word
+    w = firstNonZeroWord(a, b, 0, startWord + 1);
+    if (w <= startWord) {
+        bits = a[w] & b[w];
+        if (w == startWord) {
+            bits &= ((MaskWord)1 << startBit) - 1;
+        }
+        if (bits) {
+            return (w << 6) + __builtin_ctzll(bits);
+        }
+    }
+    return -1;
+}
+
+inline int countPorts(const MaskWord* a, const MaskWord* b, int words) {
+    int count = 0;
+    for (int w = 0; w < words; w++) {
+        count += __builtin_popcountll(a[w] & b[w]);
+    }
+    return count;
+}
+
+// The index-th port (from 0) set in both a and b; index < countPorts(a, b, words)
+inline int nthPort(const MaskWord* a, const MaskWord* b, int words, int index) {
+    for (int w = 0; w < words; w++) {
+        MaskWord bits = a[w] & b[w];
+        int count = __builtin_popcountll(bits);
+        if (index < count) {
+            for (; index > 0; index--) {
+                bits &= bits - 1;
+            }
+            return (w << 6) + __builtin_ctzll(bits);
+        }
+        index -= count;
+    }
+    return -1;
+}
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef PRIORITY_QUEUE_VOQ_H
+#define PRIORITY_QUEUE_VOQ_H
+
+#include "pending_matcher.h"
+
+// Strict priority VOQ: a matched VOQ always sends its highest priority packet
+class PriorityScheduler : public PendingInputMatcher {
+public:
+    explicit PriorityScheduler(const SimConfig& config) : PendingInputMatcher(config) {}
+
+    template <class Switch>
+    void processPackets(Switch& sw, int time);
+};
+
+// Process packets at output ports
+template <class Switch>
+void PriorityScheduler::processPackets(Switch& sw, int time) {
+    matchPendingInputs(sw);
+
+    for(int outputPort=0; outputPort<numPorts; outputPort++)
+    {
+        if(inputPortCorrespondingToOutputPort[outputPort]!=-1){
+            int inputPort=inputPortCorrespondingToOutputPort[outputPort];
+            if(sw.hasPackets(inputPort, outputPort)){
+                sw.transmit(inputPort, outputPort, sw.highestClass(inputPort, outputPort), time);
+                if (sw.hasPackets(inputPort, outputPort)) {
+                    requeue(inputPort, outputPort);  // Re-add input port to the pending queue
+                }
+            }
+        }
+    }
+    markPhase(PROFILE_DEQUEUE);
+}
+
+#endif
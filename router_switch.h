@@ -0,0 +1,943 @@
+#ifndef ROUTER_SWITCH_H
+#define ROUTER_SWITCH_H
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "packet.h"
+#include "sim_config.h"
+#include "sim_random.h"
+#include "destination_matrix.h"
+#include "trace_file.h"
+#include "voq_buffer.h"
+#include "output_buffer.h"
+#include "voq_bitmaps.h"
+#include "latency_histogram.h"
+#include "occupancy_tracker.h"
+#include "metrics_writer.h"
+#include "event_trace.h"
+#include "phase_profiler.h"
+
+// Counters shared by every scheduler
+struct SwitchStats {
+    long long packetsProcessed = 0;
+    long long totalTurnaroundTime = 0;
+    long long totalPacketsDropped = 0;
+    long long totalArrivals = 0;            // Total packets that attempted to enter the system
+    long long outputPacketsDropped = 0;     // Switched packets that found their output queue full
+    long long packetsDeparted = 0;          // Packets sent on the output links
+    long long cellsSwitched = 0;            // Cells sent across the fabric
+    long long cellsDeparted = 0;            // Cells sent on the output links
+    long long payloadDeparted = 0;          // Size units of the departed packets
+    std::vector<long long> queueThroughput; // Packets processed per output port
+    int cellSize;                          // Size units per cell, 0 without segmentation
+
+    // Slots from arrival until the last cell crossed the fabric, per class,
+    // and until it left the output, per output port and class. A packet is
+    // recorded once in each; the per-port, per-class and overall views are
+    // merged when they are read.
+    std::vector<LatencyHistogram> waitingByClass;
+    std::vector<LatencyHistogram> delayByPortClass; // Index output * NUM_CLASSES + class
+
+    // Cells buffered at each input and in each VOQ, counting the rest of a
+    // packet that is still crossing in packet mode. Inputs keep a histogram
+    // each; the VOQs share one. Both track no queues unless occupancy is on.
+    OccupancyTracker inputOccupancy;
+    OccupancyTracker voqOccupancy; // Index input * numPorts + output
+
+    SwitchStats(int numPorts, int cellSize, bool occupancy)
+        : queueThroughput(numPorts, 0), cellSize(cellSize), waitingByClass(NUM_CLASSES),
+          delayByPortClass(numPorts * NUM_CLASSES), inputOccupancy(occupancy ? numPorts : 0, true),
+          voqOccupancy(occupancy ? numPorts * numPorts : 0, false) {}
+
+    LatencyHistogram waiting() const { return mergeEvery(waitingByClass, 0, 1); }
+    LatencyHistogram delay() const { return mergeEvery(delayByPortClass, 0, 1); }
+    LatencyHistogram delayOfPort(int port) const {
+        LatencyHistogram all;
+        for (int cls = 0; cls < NUM_CLASSES; cls++) {
+            all.merge(delayByPortClass[port * NUM_CLASSES + cls]);
+        }
+        return all;
+    }
+    LatencyHistogram delayOfClass(int cls) const { return mergeEvery(delayByPortClass, cls, NUM_CLASSES); }
+
+    // Cells sent per output per slot
+    double throughput(int time) const {
+        return time > 0 ? (double)cellsDeparted / ((double)time * queueThroughput.size()) : 0;
+    }
+    // Share of the output links' cell capacity that carried packet data,
+    // leaving out the padding of partly filled last cells
+    double goodput(int time) const {
+        if (cellSize == 0) {
+            return throughput(time);
+        }
+        return time > 0 ? (double)payloadDeparted / ((double)time * queueThroughput.size() * cellSize) : 0;
+    }
+
+    void print(std::ostream& out, int time) const;
+    void printOccupancy(std::ostream& out, int time) const;
+
+private:
+    // Merges parts[first], parts[first + stride], ...
+    static LatencyHistogram mergeEvery(const std::vector<LatencyHistogram>& parts, int first, int stride) {
+        LatencyHistogram all;
+        for (size_t k = first; k < parts.size(); k += stride) {
+            all.merge(parts[k]);
+        }
+        return all;
+    }
+};
+
+// "p50 5, p99 41, p99.9 88, max 120"
+inline void printPercentiles(std::ostream& out, const LatencyHistogram& histogram) {
+    out << "p50 " << histogram.percentile(0.5) << ", p99 " << histogram.percentile(0.99)
+        << ", p99.9 " << histogram.percentile(0.999) << ", max " << histogram.max();
+}
+
+inline void SwitchStats::print(std::ostream& out, int time) const {
+    out << "Simulation Time: " << time << " units" << std::endl;
+    out << "Total Packets Processed: " << packetsProcessed << std::endl;
+
+    // Queue throughput per port
+    out << "Queue Throughput per port: " << std::endl;
+    for (size_t i = 0; i < queueThroughput.size(); i++) {
+        out << "Port " << i << ": " << queueThroughput[i] << " packets" << std::endl;
+    }
+
+    // Turnaround time and waiting time
+    LatencyHistogram allWaiting = waiting();
+    out << "Average Turnaround Time: " << (packetsProcessed ? (double)totalTurnaroundTime / packetsProcessed : 0) << " units" << std::endl;
+    out << "Average Waiting Time: " << allWaiting.mean() << " units" << std::endl;
+    out << "Waiting Time: ";
+    printPercentiles(out, allWaiting);
+    out << std::endl;
+
+    // Packet drop rate
+    out << "Total Packets Dropped: " << totalPacketsDropped << std::endl;
+    out << "Packet Drop Rate: " << (totalArrivals ? (double)totalPacketsDropped / totalArrivals * 100 : 0) << "%" << std::endl;
+    out << "Output Packets Dropped: " << outputPacketsDropped << std::endl;
+
+    // Egress
+    out << "Packets Departed: " << packetsDeparted << std::endl;
+    LatencyHistogram allDelay = delay();
+    out << "Average Output Delay: " << allDelay.mean() << " units" << std::endl;
+    out << "Output Delay: ";
+    printPercentiles(out, allDelay);
+    out << std::endl;
+    out << "Output Delay per class: " << std::endl;
+    for (int cls = 0; cls < NUM_CLASSES; cls++) {
+        LatencyHistogram classDelay = delayOfClass(cls);
+        out << "Class " << cls + 1 << ": " << classDelay.count() << " packets, mean " << classDelay.mean() << ", ";
+        printPercentiles(out, classDelay);
+        out << std::endl;
+    }
+    out << "Output Delay per port: " << std::endl;
+    for (size_t i = 0; i < queueThroughput.size(); i++) {
+        out << "Port " << i << ": ";
+        printPercentiles(out, delayOfPort((int)i));
+        out << std::endl;
+    }
+    if (cellSize > 0) {
+        out << "Cells Switched: " << cellsSwitched << std::endl;
+        out << "Cells Departed: " << cellsDeparted << std::endl;
+        out << "Throughput: " << throughput(time) << " cells per output per slot" << std::endl;
+        out << "Goodput: " << goodput(time) << " of the output link capacity" << std::endl;
+    }
+
+    if (inputOccupancy.size() > 0) {
+        printOccupancy(out, time);
+    }
+
+    out << "-----------------------------" << std::endl;
+}
+
+// Buffer occupancy, sampled at the end of every slot
+inline void SwitchStats::printOccupancy(std::ostream& out, int time) const {
+    out << "Buffer Occupancy per input: " << std::endl;
+    for (int i = 0; i < inputOccupancy.size(); i++) {
+        const LatencyHistogram& occupancy = inputOccupancy.histogram(i);
+        out << "Port " << i << ": mean " << inputOccupancy.mean(i, time) << " cells, p50 " << occupancy.percentile(0.5)
+            << ", p99 " << occupancy.percentile(0.99) << ", peak " << inputOccupancy.peak(i) << std::endl;
+    }
+    LatencyHistogram voqLevels = voqOccupancy.pooled();
+    out << "VOQ Occupancy: mean " << voqLevels.mean() << " cells, ";
+    printPercentiles(out, voqLevels);
+    out << std::endl;
+    // High-water marks of the VOQs, and the VOQ holding the most on average
+    LatencyHistogram voqPeaks;
+    int busiest = 0;
+    for (int voq = 0; voq < voqOccupancy.size(); voq++) {
+        voqPeaks.record(voqOccupancy.peak(voq));
+        if (voqOccupancy.mean(voq, time) > voqOccupancy.mean(busiest, time)) {
+            busiest = voq;
+        }
+    }
+    int ports = (int)queueThroughput.size();
+    out << "VOQ Peaks: ";
+    printPercentiles(out, voqPeaks);
+    out << std::endl;
+    out << "Busiest VOQ: input " << busiest / ports << ", output " << busiest % ports << ", mean "
+        << voqOccupancy.mean(busiest, time) << " cells, peak " << voqOccupancy.peak(busiest) << std::endl;
+}
+
+// Running totals whose change an interval metrics row reports
+struct MetricsTotals {
+    int slot = 0;
+    long long arrivals = 0;
+    long long inputDrops = 0;
+    long long outputDrops = 0;
+    long long switched = 0;
+    long long departed = 0;
+    long long cellsDeparted = 0;
+    long long delaySum = 0;
+};
+
+// No-op hooks; schedulers hide the ones they need
+struct SchedulerBase {
+    // True for the output-queued reference switch, which bypasses the VOQs
+    static const bool outputQueued = false;
+
+    int numPorts;
+    EventTracer* tracer; // config.events, null unless events are traced
+    PhaseProfiler* profiler = nullptr; // Set by the engine when config.profile is on
+
+    explicit SchedulerBase(const SimConfig& config) : numPorts(config.numPorts), tracer(config.events.get()) {}
+
+    // Charges the time since the last mark to phase
+    void markPhase(ProfilePhase phase) {
+        if (profiler) {
+            profiler->mark(phase);
+        }
+    }
+
+    void onEnqueue(int inputPort, int outputPort, int time) {}
+    void printStatistics(std::ostream& out) const {}
+};
+
+// Shared switch engine: traffic generation, VOQ buffers and statistics.
+// The Scheduler decides which VOQs are served in each time slot; it is a
+// template parameter so its processPackets() is inlined into the slot loop.
+template <class Scheduler>
+class RouterSwitch {
+public:
+    SimConfig config;
+    int numPorts;
+
+    // One FIFO per traffic class in every VOQ, holding cells
+    VoqBuffers inputQueues;
+    OutputBuffers outputQueues;
+    VoqBitmaps occupied; // Non-empty VOQs, updated on enqueue and dequeue
+    std::vector<int> inputBacklog;  // Cells queued at each input
+    std::vector<int> outputBacklog; // Cells queued in the VOQs for each output
+
+    SwitchStats stats;
+    long long phase = 0; // Scheduling phases run so far; the slot number at speedup 1
+    SimRandom random; // Traffic stream of this run
+    DestinationMatrix destinations;
+    Scheduler scheduler;
+
+    // Packets arriving at each input in the current slot, and their fields
+    std::vector<int> arrivals;
+    std::vector<int> batchOutputPort;
+    std::vector<int> batchFields; // Priority, processing time and size packed together
+    std::vector<uint32_t> batchCoins; // Alias table coins for non-uniform destinations
+
+    // Bernoulli and Poisson arrivals skip ahead over the input slots: slot t
+    // at input i is number t * numPorts + i, and nextArrival is the next one
+    // with any arrivals. Each gap is one geometric draw, so light loads cost
+    // random numbers per arrival rather than per port per slot.
+    long long nextArrival = LLONG_MAX;
+    double skipLog = 0;    // log(1 - chance that an input slot has arrivals)
+    double expNegLoad = 1; // exp(-load), for the Poisson batch sizes
+
+    // ON/OFF sources, per input: slots left in the current OFF period,
+    // packets left in the current burst, and the burst's output
+    std::vector<long long> idleLeft;
+    std::vector<int> burstLeft;
+    std::vector<int> burstOutput;
+    double burstEndLog = 0; // log(1 - 1 / burstLength)
+    double idleEndLog = 0;  // log(1 - 1 / (1 + mean OFF length))
+
+    // Segmentation: packets are cut into cells at ingress and rebuilt per
+    // output, which counts the cells received of the packet in progress
+    // from every input and class
+    bool segmented;
+    std::vector<uint16_t> reassembly; // Index (output * numPorts + input) * NUM_CLASSES + class
+
+    // Packet mode: once a packet's first cell crosses, the rest of it leaves
+    // the VOQ and crosses one cell per slot with its input and output held
+    std::vector<int> heldOutput; // Per input, -1 if it is not sending a packet
+    std::vector<int> heldClass;
+    std::vector<int> heldLeft;   // Cells still to cross
+    std::vector<Cell> heldCell;
+    std::vector<int> heldInputs; // Inputs with a held packet
+    std::vector<std::pair<int, int>> busyPorts; // Pairs taken by held packets this slot
+    std::vector<char> busyInput;
+    std::vector<char> busyOutput;
+    std::vector<int> hiddenVoqs; // Cleared from occupied while the scheduler runs
+
+    // Trace replay: the next record to arrive and the end of the mapped trace
+    const TraceRecord* traceNext = nullptr;
+    const TraceRecord* traceEnd = nullptr;
+
+    // Interval metrics: every metricsInterval slots a row with the change
+    // since the previous row and the queues as they stand
+    MetricsWriter* metrics; // config.metrics, null when off
+    long long nextMetricsSlot;
+    MetricsTotals metricsLast;
+
+    EventTracer* tracer; // config.events, null unless events are traced
+    std::unique_ptr<PhaseProfiler> profiler; // Only with config.profile
+
+    explicit RouterSwitch(const SimConfig& config)
+        : config(config),
+          numPorts(config.numPorts),
+          inputQueues(config.numPorts, config.bufferSize),
+          outputQueues(config.numPorts, config.outputBufferSize, config.drainRates()),
+          occupied(config.numPorts),
+          inputBacklog(config.numPorts, 0),
+          outputBacklog(config.numPorts, 0),
+          stats(config.numPorts, config.cellSize, config.occupancy),
+          random(config.rng, SimRandom::streamSeed(config.seed, STREAM_TRAFFIC)),
+          destinations(config),
+          scheduler(config),
+          arrivals(config.numPorts, 0),
+          segmented(config.cellSize > 0),
+          heldOutput(config.numPorts, -1),
+          heldClass(config.numPorts, 0),
+          heldLeft(config.numPorts, 0),
+          heldCell(config.numPorts),
+          busyInput(config.numPorts, 0),
+          busyOutput(config.numPorts, 0),
+          metrics(config.metrics.get()),
+          nextMetricsSlot(config.metricsInterval),
+          tracer(config.events.get()) {
+        if (segmented && !Scheduler::outputQueued) {
+            reassembly.assign((size_t)numPorts * numPorts * NUM_CLASSES, 0);
+        }
+        double load = config.meanArrivals();
+        if ((config.traffic == TRAFFIC_BERNOULLI || config.traffic == TRAFFIC_POISSON) && load > 0) {
+            expNegLoad = std::exp(-load);
+            double busy = config.traffic == TRAFFIC_BERNOULLI ? load : 1 - expNegLoad;
+            skipLog = std::log1p(-busy);
+            nextArrival = random.geometric(skipLog);
+        }
+        if (config.traffic == TRAFFIC_ON_OFF) {
+            // Mean OFF length B (1 - load) / load makes ON a load share of the time
+            double meanIdle = load > 0 ? config.burstLength * (1 - load) / load : 0;
+            burstEndLog = std::log1p(-1 / config.burstLength);
+            idleEndLog = std::log1p(-1 / (1 + meanIdle));
+            idleLeft.assign(numPorts, LLONG_MAX);
+            burstLeft.assign(numPorts, 0);
+            burstOutput.assign(numPorts, 0);
+            // Every source starts at the beginning of an OFF period
+            for (int i = 0; load > 0 && i < numPorts; i++) {
+                idleLeft[i] = random.geometric(idleEndLog);
+            }
+        }
+        if (config.traffic == TRAFFIC_TRACE && config.trace) {
+            traceNext = config.trace->records();
+            traceEnd = traceNext + config.trace->count();
+        }
+        if (metrics) {
+            startMetrics();
+        }
+        if (config.profile) {
+            profiler.reset(new PhaseProfiler());
+            scheduler.profiler = profiler.get();
+        }
+    }
+
+    void simulate();
+    void generatePackets_uniform(int time);
+    void generatePackets_non_uniform(int time);
+    void generatePackets_bursty(int time);
+    void generatePackets_bernoulli(int time) { generateSkipAhead(time, false); }
+    void generatePackets_poisson(int time) { generateSkipAhead(time, true); }
+    void generatePackets_on_off(int time);
+    void generatePackets_trace(int time);
+    void processPackets(int time);
+    void drainOutputs(int time);
+    void markPhase(ProfilePhase phase) {
+        if (profiler) {
+            profiler->mark(phase);
+        }
+    }
+    // Admits one packet arriving at an input; the generators feed every
+    // packet through here, and the benchmarks use it to load VOQ snapshots
+    void enqueue(int inputPort, const Packet& pkt, int time);
+
+    // Helpers used by the schedulers
+    int voqIndex(int inputPort, int outputPort) const { return inputQueues.index(inputPort, outputPort); }
+    int bufferOccupancy(int inputPort, int outputPort) const { return inputQueues.size(voqIndex(inputPort, outputPort)); }
+    bool hasPackets(int inputPort, int outputPort) const { return bufferOccupancy(inputPort, outputPort) > 0; }
+    bool hasPackets(int inputPort, int outputPort, int cls) const { return !inputQueues.empty(voqIndex(inputPort, outputPort), cls); }
+    const Cell& headCell(int inputPort, int outputPort, int cls) const { return inputQueues.front(voqIndex(inputPort, outputPort), cls); }
+    int highestClass(int inputPort, int outputPort) const;
+    int oldestArrivalTime(int inputPort, int outputPort) const;
+    void transmit(int inputPort, int outputPort, int cls, int time);
+    // Ports taken this slot by packets already crossing in packet mode
+    bool inputBusy(int inputPort) const { return busyInput[inputPort]; }
+    bool outputBusy(int outputPort) const { return busyOutput[outputPort]; }
+    // What a fair queueing scheduler charges for sending cell: the whole
+    // packet, or only this cell's share when cells of packets interleave
+    int serviceSize(const Cell& cell) const {
+        if (!segmented || config.packetMode) {
+            return cell.size;
+        }
+        return cell.flags & CELL_LAST ? (cell.size - 1) % config.cellSize + 1 : config.cellSize;
+    }
+
+private:
+    int arrivalCount(double mean);
+    void generateSkipAhead(int time, bool batches);
+    void admitArrivals(int time, const int* fixedOutputs = nullptr);
+    void continueHeldPackets(int time);
+    void hideVoqs(const MaskWord* row, int port, bool byInput);
+    void crossFabric(int inputPort, int outputPort, int cls, const Cell& cell, int time);
+    void deliver(int inputPort, int outputPort, int cls, const Cell& cell);
+    void queuePacket(int inputPort, int outputPort, const Cell& cell, int cells);
+    void trackOccupancy(int inputPort, int outputPort, int time);
+    void startMetrics();
+    void writeMetrics(int slot);
+};
+
+// Draws the fields of every packet arriving this slot, arrivals[i] of them
+// at input i, in bulk passes: the output port (a uniform column, plus an
+// alias table coin unless destinations are uniform), and one value in
+// [0, 300) that splits into priority (3), processing time (10) and size (10).
+// Then enqueues the packets input by input. Generators that pick
+// destinations themselves pass fixedOutputs, one output per input.
+template <class Scheduler>
+void RouterSwitch<Scheduler>::admitArrivals(int time, const int* fixedOutputs) {
+    int total = 0;
+    for (int i = 0; i < numPorts; i++) {
+        total += arrivals[i];
+    }
+    if (total == 0) {
+        return;
+    }
+    if ((int)batchOutputPort.size() < total) {
+        batchOutputPort.resize(total);
+        batchFields.resize(total);
+        batchCoins.resize(total);
+    }
+    bool skewed = !fixedOutputs && !destinations.uniform();
+    if (!fixedOutputs) {
+        random.uniformInts(batchOutputPort.data(), total, numPorts);
+    }
+    if (skewed) {
+        random.words(batchCoins.data(), total);
+    }
+    random.uniformInts(batchFields.data(), total, NUM_CLASSES * 10 * 10);
+
+    const int* outputPorts = batchOutputPort.data();
+    const uint32_t* coins = batchCoins.data();
+    const int* fields = batchFields.data();
+    for (int i = 0; i < numPorts; i++) {
+        for (int j = 0; j < arrivals[i]; j++) {
+            int field = *fields++;
+            int outputPort;
+            if (fixedOutputs) {
+                outputPort = fixedOutputs[i];
+            } else if (skewed) {
+                outputPort = destinations.resolve(i, *outputPorts++, *coins++);
+            } else {
+                outputPort = *outputPorts++;
+            }
+            Packet pkt;
+            pkt.priority = field % NUM_CLASSES + 1;             // Random priority between 1 and 3
+            pkt.arrivalTime = time;
+            pkt.processingTime = field / NUM_CLASSES % 10 + 1;  // Random processing time between 1 and 10 units
+            pkt.outputPort = outputPort;
+            pkt.size = field / (NUM_CLASSES * 10) + 1;          // Packet size between 1 and 10 units
+            enqueue(i, pkt, time);
+        }
+    }
+}
+
+template <class Scheduler>
+void RouterSwitch<Scheduler>::enqueue(int inputPort, const Packet& pkt, int time) {
+    stats.totalArrivals++;
+
+    int outputPort = pkt.outputPort;
+    int cells = config.cellsPerPacket(pkt.size);
+    Cell cell;
+    cell.arrivalTime = pkt.arrivalTime;
+    cell.size = (uint16_t)pkt.size;
+    cell.processingTime = (uint8_t)pkt.processingTime;
+    uint8_t classBits = (uint8_t)((pkt.priority - 1) << CELL_CLASS_SHIFT);
+    cell.flags = CELL_FIRST | CELL_LAST | classBits;
+
+    // Reference output-queued switch: packets go straight to their output
+    if (Scheduler::outputQueued) {
+        stats.waitingByClass[pkt.priority - 1].record(0);
+        stats.totalTurnaroundTime += pkt.processingTime;
+        stats.packetsProcessed++;
+        stats.queueThroughput[outputPort]++;
+        stats.cellsSwitched += cells;
+        if (EVENT_TRACING && tracer) {
+            tracer->record(EVENT_ENQUEUE, inputPort, outputPort, cells, pkt.priority - 1);
+        }
+        queuePacket(inputPort, outputPort, cell, cells);
+        return;
+    }
+
+    // The whole packet must fit, counting the cells of a held packet that
+    // have left the VOQ but not yet the input
+    int voq = voqIndex(inputPort, outputPort);
+    int queued = inputQueues.size(voq);
+    if (heldOutput[inputPort] == outputPort) {
+        queued += heldLeft[inputPort];
+    }
+    if (queued + cells <= config.bufferSize) {
+        if (inputQueues.size(voq) == 0) {
+            occupied.set(inputPort, outputPort);
+        }
+        for (int k = 0; k < cells; k++) {
+            cell.flags = (k == 0 ? CELL_FIRST : 0) | (k == cells - 1 ? CELL_LAST : 0) | classBits;
+            inputQueues.push(voq, pkt.priority - 1, cell);
+        }
+        inputBacklog[inputPort] += cells;
+        outputBacklog[outputPort] += cells;
+        trackOccupancy(inputPort, outputPort, time);
+        if (EVENT_TRACING && tracer) {
+            tracer->record(EVENT_ENQUEUE, inputPort, outputPort, cells, pkt.priority - 1);
+        }
+        scheduler.onEnqueue(inputPort, outputPort, time);
+    } else {
+        stats.totalPacketsDropped++;
+        if (EVENT_TRACING && tracer) {
+            tracer->record(EVENT_DROP, inputPort, outputPort, cells, pkt.priority - 1);
+        }
+    }
+}
+
+// Whole packets for a mean of mean per slot: the integer part always
+// arrives, and the fractional part is one more packet with that probability
+template <class Scheduler>
+int RouterSwitch<Scheduler>::arrivalCount(double mean) {
+    int count = (int)mean;
+    double fraction = mean - count;
+    if (fraction > 0 && random.bernoulli(fraction)) {
+        count++;
+    }
+    return count;
+}
+
+// Generate packets at input ports
+template <class Scheduler>
+void RouterSwitch<Scheduler>::generatePackets_uniform(int time) {
+    double mean = config.meanArrivals();
+    for (int i = 0; i < numPorts; i++) {
+        arrivals[i] = arrivalCount(mean);
+    }
+    admitArrivals(time);
+}
+
+// Generate packets at input ports (non-uniform traffic). Each input draws
+// its rate every slot: 0 to 9 packets, or 0 to twice the load when set.
+template <class Scheduler>
+void RouterSwitch<Scheduler>::generatePackets_non_uniform(int time) {
+    for (int i = 0; i < numPorts; i++) {
+        arrivals[i] = config.load >= 0 ? arrivalCount(2 * config.load * random.uniform()) : random.uniformInt(10);
+    }
+    admitArrivals(time);
+}
+
+// Generate bursty traffic at input ports
+template <class Scheduler>
+void RouterSwitch<Scheduler>::generatePackets_bursty(int time) {
+    double mean = config.meanArrivals();
+    for (int i = 0; i < numPorts; i++) {
+        bool isBursty = random.uniformInt(100) < 30; // 30% chance for bursty traffic at a given time
+        arrivals[i] = arrivalCount(isBursty ? mean * 2 : mean / 2);
+    }
+    admitArrivals(time);
+}
+
+// Bernoulli and Poisson arrivals. Only the input slots that get packets
+// cost random numbers: one for the gap to the next, and for Poisson one
+// more for the batch size, which is at least 1 there.
+template <class Scheduler>
+void RouterSwitch<Scheduler>::generateSkipAhead(int time, bool batches) {
+    std::fill(arrivals.begin(), arrivals.end(), 0);
+    long long first = (long long)time * numPorts;
+    long long end = first + numPorts;
+    double load = config.meanArrivals();
+    while (nextArrival < end) {
+        arrivals[nextArrival - first] = batches ? random.positivePoisson(load, expNegLoad) : 1;
+        long long gap = random.geometric(skipLog);
+        nextArrival = gap < LLONG_MAX - nextArrival ? nextArrival + 1 + gap : LLONG_MAX;
+    }
+    admitArrivals(time);
+}
+
+// Markov ON/OFF sources. An ON period sends one packet per slot, all to one
+// output drawn from the input's destination row when the burst starts; its
+// length is geometric with mean burstLength. OFF periods are geometric too,
+// sized so that a source is ON for a load share of the slots. Each period
+// costs one draw at its start.
+template <class Scheduler>
+void RouterSwitch<Scheduler>::generatePackets_on_off(int time) {
+    for (int i = 0; i < numPorts; i++) {
+        arrivals[i] = 0;
+        if (idleLeft[i] > 0) {
+            idleLeft[i]--;
+            continue;
+        }
+        if (burstLeft[i] == 0) {
+            long long length = 1 + random.geometric(burstEndLog);
+            burstLeft[i] = length < INT_MAX ? (int)length : INT_MAX;
+            burstOutput[i] = destinations.sample(random, i);
+        }
+        arrivals[i] = 1;
+        if (--burstLeft[i] == 0) {
+            idleLeft[i] = random.geometric(idleEndLog);
+        }
+    }
+    admitArrivals(time, burstOutput.data());
+}
+
+// Trace replay. Every record stamped before the end of this slot is
+// enqueued straight from the mapped file, so there is no copy and no
+// allocation per packet. Sizes are rounded up to TRACE_SIZE_UNIT bytes.
+template <class Scheduler>
+void RouterSwitch<Scheduler>::generatePackets_trace(int time) {
+    uint64_t slotEnd = (uint64_t)(time + 1) * config.traceSlotNanos;
+    for (; traceNext != traceEnd && traceNext->timestamp < slotEnd; traceNext++) {
+        const TraceRecord& record = *traceNext;
+        // The header bounds the ports; skip records that break it
+        if (record.inputPort >= numPorts || record.outputPort >= numPorts) {
+            continue;
+        }
+        Packet pkt;
+        pkt.priority = record.trafficClass < NUM_CLASSES ? record.trafficClass + 1 : NUM_CLASSES;
+        pkt.arrivalTime = time;
+        pkt.processingTime = 1;
+        pkt.outputPort = record.outputPort;
+        pkt.size = std::max(1, (record.size + TRACE_SIZE_UNIT - 1) / TRACE_SIZE_UNIT);
+        enqueue(record.inputPort, pkt, time);
+    }
+}
+
+// Highest non-empty traffic class of a VOQ, or -1 if it is empty
+template <class Scheduler>
+int RouterSwitch<Scheduler>::highestClass(int inputPort, int outputPort) const {
+    unsigned mask = inputQueues.classMask(voqIndex(inputPort, outputPort));
+    return mask ? __builtin_ctz(mask) : -1;
+}
+
+// Arrival time of the oldest packet at the head of any class of a non-empty VOQ
+template <class Scheduler>
+int RouterSwitch<Scheduler>::oldestArrivalTime(int inputPort, int outputPort) const {
+    int voq = voqIndex(inputPort, outputPort);
+    unsigned mask = inputQueues.classMask(voq);
+    int oldest = inputQueues.front(voq, __builtin_ctz(mask)).arrivalTime;
+    for (mask &= mask - 1; mask; mask &= mask - 1) {
+        int arrivalTime = inputQueues.front(voq, __builtin_ctz(mask)).arrivalTime;
+        if (arrivalTime < oldest) {
+            oldest = arrivalTime;
+        }
+    }
+    return oldest;
+}
+
+// Move the head cell of a VOQ class across the fabric
+template <class Scheduler>
+void RouterSwitch<Scheduler>::transmit(int inputPort, int outputPort, int cls, int time) {
+    int voq = voqIndex(inputPort, outputPort);
+    Cell cell = inputQueues.front(voq, cls);
+    inputQueues.pop(voq, cls);
+    int cells = 1;
+    if (config.packetMode && !(cell.flags & CELL_LAST)) {
+        // The rest of the packet follows in the next slots
+        cells = config.cellsPerPacket(cell.size);
+        for (int k = 1; k < cells; k++) {
+            inputQueues.pop(voq, cls);
+        }
+        heldOutput[inputPort] = outputPort;
+        heldClass[inputPort] = cls;
+        heldLeft[inputPort] = cells - 1;
+        heldCell[inputPort] = cell;
+        heldInputs.push_back(inputPort);
+    }
+    inputBacklog[inputPort] -= cells;
+    outputBacklog[outputPort] -= cells;
+    if (inputQueues.size(voq) == 0) {
+        occupied.clear(inputPort, outputPort);
+    }
+    trackOccupancy(inputPort, outputPort, time);
+    if (EVENT_TRACING && tracer) {
+        tracer->record(EVENT_DEQUEUE, inputPort, outputPort, time - cell.arrivalTime, cls);
+    }
+    crossFabric(inputPort, outputPort, cls, cell, time);
+}
+
+// A cell reaches its output. Packet statistics are taken when the last
+// cell crosses, so waiting covers the whole packet.
+template <class Scheduler>
+void RouterSwitch<Scheduler>::crossFabric(int inputPort, int outputPort, int cls, const Cell& cell, int time) {
+    stats.cellsSwitched++;
+    if (cell.flags & CELL_LAST) {
+        int waitingTime = time - cell.arrivalTime;
+        stats.waitingByClass[cls].record(waitingTime);
+        stats.totalTurnaroundTime += waitingTime + cell.processingTime;
+        stats.packetsProcessed++;
+        stats.queueThroughput[outputPort]++;
+    }
+    deliver(inputPort, outputPort, cls, cell);
+}
+
+// Reassembly: cells of a packet arrive in order, so the output only counts
+// them, and queues the packet for the line when the last one is in
+template <class Scheduler>
+void RouterSwitch<Scheduler>::deliver(int inputPort, int outputPort, int cls, const Cell& cell) {
+    int cells = 1;
+    if (segmented) {
+        uint16_t& received = reassembly[((size_t)outputPort * numPorts + inputPort) * NUM_CLASSES + cls];
+        if (!(cell.flags & CELL_LAST)) {
+            received++;
+            return;
+        }
+        cells = received + 1;
+        received = 0;
+    }
+    queuePacket(inputPort, outputPort, cell, cells);
+}
+
+template <class Scheduler>
+void RouterSwitch<Scheduler>::queuePacket(int inputPort, int outputPort, const Cell& cell, int cells) {
+    if (outputQueues.full(outputPort, cells)) {
+        stats.outputPacketsDropped++;
+        if (EVENT_TRACING && tracer) {
+            tracer->record(EVENT_OUTPUT_DROP, inputPort, outputPort, cells, cellClass(cell));
+        }
+    } else {
+        outputQueues.push(outputPort, cell, cells);
+    }
+}
+
+// Records the levels of an input and one of its VOQs after a change. The
+// cells of a packet still crossing in packet mode stay in the input's
+// buffer, as admission counts them.
+template <class Scheduler>
+void RouterSwitch<Scheduler>::trackOccupancy(int inputPort, int outputPort, int time) {
+    if (!config.occupancy) {
+        return;
+    }
+    int held = heldOutput[inputPort] >= 0 ? heldLeft[inputPort] : 0;
+    int voqHeld = heldOutput[inputPort] == outputPort ? held : 0;
+    stats.inputOccupancy.update(inputPort, inputBacklog[inputPort] + held, time);
+    stats.voqOccupancy.update(voqIndex(inputPort, outputPort), bufferOccupancy(inputPort, outputPort) + voqHeld, time);
+}
+
+// Packet mode: inputs sending a packet move its next cell first, then sit
+// out the scheduling with their outputs. The matching schedulers read the
+// occupancy bitmaps, so the VOQs of busy ports are hidden from them until
+// the slot's decisions are made; the others ask inputBusy()/outputBusy().
+template <class Scheduler>
+void RouterSwitch<Scheduler>::processPackets(int time) {
+    if (heldInputs.empty()) {
+        scheduler.processPackets(*this, time);
+        return;
+    }
+    continueHeldPackets(time);
+    markPhase(PROFILE_DEQUEUE);
+    scheduler.processPackets(*this, time);
+    for (int voq : hiddenVoqs) {
+        occupied.set(voq / numPorts, voq % numPorts);
+    }
+    hiddenVoqs.clear();
+    for (const std::pair<int, int>& busy : busyPorts) {
+        busyInput[busy.first] = 0;
+        busyOutput[busy.second] = 0;
+    }
+    busyPorts.clear();
+}
+
+template <class Scheduler>
+void RouterSwitch<Scheduler>::continueHeldPackets(int time) {
+    size_t kept = 0;
+    for (int inputPort : heldInputs) {
+        int outputPort = heldOutput[inputPort];
+        busyPorts.push_back(std::make_pair(inputPort, outputPort));
+        busyInput[inputPort] = 1;
+        busyOutput[outputPort] = 1;
+        Cell cell = heldCell[inputPort];
+        cell.flags &= ~(CELL_FIRST | CELL_LAST);
+        if (--heldLeft[inputPort] == 0) {
+            cell.flags |= CELL_LAST;
+            heldOutput[inputPort] = -1;
+        } else {
+            heldInputs[kept++] = inputPort;
+        }
+        trackOccupancy(inputPort, outputPort, time);
+        crossFabric(inputPort, outputPort, heldClass[inputPort], cell, time);
+    }
+    heldInputs.resize(kept);
+    for (const std::pair<int, int>& busy : busyPorts) {
+        hideVoqs(occupied.byInput(busy.first), busy.first, true);
+        hideVoqs(occupied.byOutput(busy.second), busy.second, false);
+    }
+}
+
+// Clears every VOQ of one input's (byInput) or output's row from occupied
+template <class Scheduler>
+void RouterSwitch<Scheduler>::hideVoqs(const MaskWord* row, int port, bool byInput) {
+    for (int w = 0; w < occupied.maskWordCount(); w++) {
+        // Copied, since clearing a VOQ updates the row
+        for (MaskWord bits = row[w]; bits; bits &= bits - 1) {
+            int other = w * 64 + __builtin_ctzll(bits);
+            int inputPort = byInput ? port : other;
+            int outputPort = byInput ? other : port;
+            occupied.clear(inputPort, outputPort);
+            hiddenVoqs.push_back(voqIndex(inputPort, outputPort));
+        }
+    }
+}
+
+// Send cells out of every output at its line rate
+template <class Scheduler>
+void RouterSwitch<Scheduler>::drainOutputs(int time) {
+    for (int outputPort = 0; outputPort < numPorts; outputPort++) {
+        LatencyHistogram* portDelay = &stats.delayByPortClass[outputPort * NUM_CLASSES];
+        stats.cellsDeparted += outputQueues.drain(outputPort, [&](const Cell& cell) {
+            stats.packetsDeparted++;
+            stats.payloadDeparted += cell.size;
+            portDelay[cellClass(cell)].record(time - cell.arrivalTime);
+        });
+    }
+}
+
+template <class Scheduler>
+void RouterSwitch<Scheduler>::startMetrics() {
+    static const char* const names[] = {"slot", "arrivals", "input_drops", "output_drops", "switched", "departed",
+                                        "throughput", "avg_delay", "voq_cells", "voq_max", "active_voqs", "output_cells"};
+    for (const char* name : names) {
+        metrics->addColumn(name);
+    }
+    if (config.metricsVoqs) {
+        metrics->addColumn("voq", numPorts * numPorts);
+    }
+}
+
+// One row covering the slots since the last one. Counters are differences
+// of running totals; occupancy walks the non-empty VOQs only, unless every
+// VOQ is reported.
+template <class Scheduler>
+void RouterSwitch<Scheduler>::writeMetrics(int slot) {
+    MetricsTotals now;
+    now.slot = slot;
+    now.arrivals = stats.totalArrivals;
+    now.inputDrops = stats.totalPacketsDropped;
+    now.outputDrops = stats.outputPacketsDropped;
+    now.switched = stats.packetsProcessed;
+    now.departed = stats.packetsDeparted;
+    now.cellsDeparted = stats.cellsDeparted;
+    for (const LatencyHistogram& histogram : stats.delayByPortClass) {
+        now.delaySum += histogram.sum();
+    }
+    const MetricsTotals& last = metricsLast;
+    long long departed = now.departed - last.departed;
+    int slots = now.slot - last.slot;
+
+    long long voqCells = 0;
+    long long outputCells = 0;
+    int voqMax = 0;
+    int activeVoqs = 0;
+    for (int i = 0; i < numPorts; i++) {
+        voqCells += inputBacklog[i];
+        outputCells += outputQueues.size(i);
+        const MaskWord* row = occupied.byInput(i);
+        for (int w = 0; w < occupied.maskWordCount(); w++) {
+            for (MaskWord bits = row[w]; bits; bits &= bits - 1) {
+                voqMax = std::max(voqMax, inputQueues.size(voqIndex(i, w * 64 + __builtin_ctzll(bits))));
+                activeVoqs++;
+            }
+        }
+    }
+
+    metrics->beginRow();
+    metrics->put(now.slot);
+    metrics->put(now.arrivals - last.arrivals);
+    metrics->put(now.inputDrops - last.inputDrops);
+    metrics->put(now.outputDrops - last.outputDrops);
+    metrics->put(now.switched - last.switched);
+    metrics->put(departed);
+    metrics->put(slots > 0 ? (double)(now.cellsDeparted - last.cellsDeparted) / ((double)slots * numPorts) : 0.0);
+    metrics->put(departed > 0 ? (double)(now.delaySum - last.delaySum) / departed : 0.0);
+    metrics->put(voqCells);
+    metrics->put(voqMax);
+    metrics->put(activeVoqs);
+    metrics->put(outputCells);
+    if (config.metricsVoqs) {
+        for (int voq = 0; voq < numPorts * numPorts; voq++) {
+            metrics->put(inputQueues.size(voq));
+        }
+    }
+    metrics->endRow();
+    metricsLast = now;
+    nextMetricsSlot = (long long)slot + config.metricsInterval;
+}
+
+template <class Scheduler>
+void RouterSwitch<Scheduler>::simulate() {
+    if (profiler) {
+        profiler->start();
+    }
+    for (int time = 0; time < config.simulationTime; time++) {
+        if (EVENT_TRACING && tracer) {
+            tracer->setSlot(time, 0);
+        }
+        if (config.traffic == TRAFFIC_UNIFORM) {
+            generatePackets_uniform(time);
+        } else if (config.traffic == TRAFFIC_NON_UNIFORM) {
+            generatePackets_non_uniform(time);
+        } else if (config.traffic == TRAFFIC_BURSTY) {
+            generatePackets_bursty(time);
+        } else if (config.traffic == TRAFFIC_BERNOULLI) {
+            generatePackets_bernoulli(time);
+        } else if (config.traffic == TRAFFIC_POISSON) {
+            generatePackets_poisson(time);
+        } else if (config.traffic == TRAFFIC_ON_OFF) {
+            generatePackets_on_off(time);
+        } else if (config.traffic == TRAFFIC_TRACE) {
+            generatePackets_trace(time);
+        }
+        markPhase(PROFILE_GENERATE);
+        // A fabric with speedup S runs floor(S * (t + 1)) phases by the end
+        // of slot t, so S = 1.5 alternates one and two phases per slot. The
+        // count outgrows an int on long runs with speedup.
+        long long phases = (long long)std::floor(config.speedup * (time + 1.0) + 1e-9);
+        for (long long first = phase; phase < phases; phase++) {
+            if (EVENT_TRACING && tracer) {
+                tracer->setSlot(time, (int)(phase - first));
+            }
+            processPackets(time);
+            markPhase(PROFILE_MATCH);
+        }
+        drainOutputs(time);
+        markPhase(PROFILE_DRAIN);
+        if (metrics && time + 1 == nextMetricsSlot) {
+            writeMetrics(time + 1);
+            markPhase(PROFILE_STATS);
+        }
+    }
+    // A last, shorter interval
+    if (metrics && metricsLast.slot < config.simulationTime) {
+        writeMetrics(config.simulationTime);
+    }
+    stats.inputOccupancy.finish(config.simulationTime);
+    stats.voqOccupancy.finish(config.simulationTime);
+    if (profiler) {
+        profiler->mark(PROFILE_STATS);
+        profiler->stop();
+    }
+}
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef RR_VOQ_H
+#define RR_VOQ_H
+
+#include <vector>
+#include "pending_matcher.h"
+
+// Per-VOQ round robin over the traffic classes
+class ClassRoundRobin {
+public:
+    explicit ClassRoundRobin(int numPorts)
+        : numPorts(numPorts),
+          currentPriority(numPorts * numPorts, NUM_CLASSES - 1) {}
+
+    // Next non-empty class starting from the VOQ's round-robin position
+    template <class Switch>
+    int nextClass(const Switch& sw, int inputPort, int outputPort) const {
+        int priority=currentPriority[inputPort*numPorts+outputPort];
+        int cnt=0;
+        while (!sw.hasPackets(inputPort, outputPort, priority) && cnt < NUM_CLASSES) {
+            priority = (priority + NUM_CLASSES - 1) % NUM_CLASSES;
+            cnt++;
+        }
+        return priority;
+    }
+
+    // The VOQ just sent from class priority; move past it
+    void advance(int inputPort, int outputPort, int priority) {
+        currentPriority[inputPort*numPorts+outputPort] = (priority + NUM_CLASSES - 1) % NUM_CLASSES;
+    }
+
+private:
+    int numPorts;
+    std::vector<int> currentPriority; // Per VOQ, indexed input * numPorts + output
+};
+
+// Round robin VOQ: a matched VOQ cycles through its traffic classes
+class RoundRobinScheduler : public PendingInputMatcher {
+public:
+    ClassRoundRobin classes;
+
+    explicit RoundRobinScheduler(const SimConfig& config)
+        : PendingInputMatcher(config),
+          classes(numPorts) {}
+
+    template <class Switch>
+    void processPackets(Switch& sw, int time);
+};
+
+template <class Switch>
+void RoundRobinScheduler::processPackets(Switch& sw, int time) {
+    matchPendingInputs(sw);
+
+    for(int outputPort=0; outputPort<numPorts; outputPort++)
+    {
+        if(inputPortCorrespondingToOutputPort[outputPort]!=-1){
+            int inputPort=inputPortCorrespondingToOutputPort[outputPort];
+            if(sw.hasPackets(inputPort, outputPort)){
+                int priority=classes.nextClass(sw, inputPort, outputPort);
+                sw.transmit(inputPort, outputPort, priority, time);
+                classes.advance(inputPort, outputPort, priority);
+                if (sw.hasPackets(inputPort, outputPort)) {
+                    requeue(inputPort, outputPort);  // Re-add input port to the pending queue
+                }
+            }
+        }
+    }
+    markPhase(PROFILE_DEQUEUE);
+}
+
+#endif
@@ -0,0 +1,392 @@
+// Microbenchmark: the processPackets decision of every VOQ scheduler on the
+// same pre-generated workloads. Each workload is a VOQ occupancy snapshot to
+// start from plus a recorded stream of Bernoulli arrivals, so no random
+// numbers are drawn while timing. Only the scheduling call of each slot is
+// timed; arrivals and the output drain run between the timed calls. On
+// Linux, cache and branch misses of the timed calls are read through
+// perf_event_open when the kernel allows it.
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include "islip.h"
+#include "priority_queue_voq.h"
+#include "rr_voq.h"
+#include "wfq_voq.h"
+#include "pim.h"
+#include "drrm.h"
+#include "wavefront.h"
+#include "hopcroft_karp.h"
+#include "max_weight.h"
+#include "lqf_approx.h"
+
+using namespace std;
+using namespace std::chrono;
+
+const int BENCH_BUFFER = 16;     // Cells per VOQ; keeps 512-port arenas small
+const int ARRIVAL_SLOTS = 256;   // Recorded slots of arrivals, replayed in a loop
+const int WARMUP_SLOTS = 32;     // Untimed slots to settle pointers and credits
+const int MIN_SLOTS = 3;
+const int MAX_SLOTS = 1000000;
+const double MIN_TIMED_NS = 1e8; // Timed scheduling per point
+const double MAX_WARMUP_NS = 5e8;
+
+// Counters over the timed calls only: the group is enabled just around
+// each call. Unavailable when the kernel or its paranoia level refuses.
+class PerfCounters {
+public:
+    PerfCounters() {
+#ifdef __linux__
+        leader = open(PERF_COUNT_HW_CACHE_MISSES, -1);
+        if (leader >= 0) {
+            branches = open(PERF_COUNT_HW_BRANCH_MISSES, leader);
+        }
+        if (branches < 0 && leader >= 0) {
+            close(leader);
+            leader = -1;
+        }
+#endif
+    }
+    ~PerfCounters() {
+#ifdef __linux__
+        if (leader >= 0) {
+            close(branches);
+            close(leader);
+        }
+#endif
+    }
+
+    bool available() const { return leader >= 0; }
+
+    void reset() {
+#ifdef __linux__
+        if (leader >= 0) {
+            ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+    void start() {
+#ifdef __linux__
+        if (leader >= 0) {
+            ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+    void stop() {
+#ifdef __linux__
+        if (leader >= 0) {
+            ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+    // Totals since reset(), false if unavailable
+    bool read(long long& cacheMisses, long long& branchMisses) const {
+#ifdef __linux__
+        uint64_t values[3]; // nr, then one value per counter
+        if (leader >= 0 && ::read(leader, values, sizeof(values)) == (ssize_t)sizeof(values)) {
+            cacheMisses = (long long)values[1];
+            branchMisses = (long long)values[2];
+            return true;
+        }
+#endif
+        return false;
+    }
+
+private:
+#ifdef __linux__
+    static int open(uint64_t config, int group) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = group < 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+    }
+#endif
+
+    int leader = -1;
+    int branches = -1;
+};
+
+// A starting occupancy and the arrivals that follow, shared by every
+// scheduler at one port count and load
+struct Workload {
+    int numPorts;
+    double load;
+    vector<int> initialCells;   // Per VOQ, input * numPorts + output
+    vector<int> slotStart;      // Arrivals of slot s are [slotStart[s], slotStart[s + 1])
+    vector<int> arrivalInput;
+    vector<int> arrivalOutput;
+    vector<int> arrivalClass;
+};
+
+// Each VOQ is busy with probability load and then holds a geometric number
+// of cells with mean 1 / (1 - load), the queue of a lightly coupled M/M/1;
+// each input then receives a packet per slot with probability load
+static Workload makeWorkload(int numPorts, double load, SimRandom& random) {
+    Workload work;
+    work.numPorts = numPorts;
+    work.load = load;
+    work.initialCells.assign(numPorts * numPorts, 0);
+    double stayLog = log(load);
+    for (int& cells : work.initialCells) {
+        if (random.bernoulli(load)) {
+            cells = (int)min<long long>(BENCH_BUFFER, 1 + random.geometric(stayLog));
+        }
+    }
+    for (int s = 0; s < ARRIVAL_SLOTS; s++) {
+        work.slotStart.push_back((int)work.arrivalInput.size());
+        for (int i = 0; i < numPorts; i++) {
+            if (random.bernoulli(load)) {
+                work.arrivalInput.push_back(i);
+                work.arrivalOutput.push_back(random.uniformInt(numPorts));
+                work.arrivalClass.push_back(random.uniformInt(NUM_CLASSES));
+            }
+        }
+    }
+    work.slotStart.push_back((int)work.arrivalInput.size());
+    return work;
+}
+
+struct BenchResult {
+    long long slots = 0;
+    double nsPerDecision = 0;
+    double matchesPerDecision = 0;
+    double matchesPerSecond = 0;
+    bool counted = false;
+    double cacheMisses = 0;  // Per decision
+    double branchMisses = 0;
+};
+
+// Mean cost of the two clock reads around a timed call
+static double timerOverheadNs() {
+    const int reads = 100000;
+    double total = 0;
+    for (int k = 0; k < reads; k++) {
+        steady_clock::time_point start = steady_clock::now();
+        steady_clock::time_point end = steady_clock::now();
+        total += duration<double, nano>(end - start).count();
+    }
+    return total / reads;
+}
+
+template <class Scheduler>
+static BenchResult benchScheduler(const Workload& work, PerfCounters& counters, double overheadNs) {
+    SimConfig config;
+    config.numPorts = work.numPorts;
+    config.bufferSize = BENCH_BUFFER;
+    config.simulationTime = 0;
+    config.load = 0;
+    unique_ptr<RouterSwitch<Scheduler>> sw(new RouterSwitch<Scheduler>(config));
+
+    Packet pkt;
+    pkt.arrivalTime = 0;
+    pkt.processingTime = 1;
+    pkt.size = 1;
+    for (int voq = 0; voq < work.numPorts * work.numPorts; voq++) {
+        pkt.outputPort = voq % work.numPorts;
+        for (int k = 0; k < work.initialCells[voq]; k++) {
+            pkt.priority = k % NUM_CLASSES + 1;
+            sw->enqueue(voq / work.numPorts, pkt, 0);
+        }
+    }
+
+    int time = 0;
+    auto admit = [&]() {
+        int s = time % ARRIVAL_SLOTS;
+        for (int a = work.slotStart[s]; a < work.slotStart[s + 1]; a++) {
+            pkt.priority = work.arrivalClass[a] + 1;
+            pkt.arrivalTime = time;
+            pkt.outputPort = work.arrivalOutput[a];
+            sw->enqueue(work.arrivalInput[a], pkt, time);
+        }
+    };
+
+    steady_clock::time_point warmupStart = steady_clock::now();
+    while (time < WARMUP_SLOTS && duration<double, nano>(steady_clock::now() - warmupStart).count() < MAX_WARMUP_NS) {
+        admit();
+        sw->processPackets(time);
+        sw->phase++;
+        sw->drainOutputs(time);
+        time++;
+    }
+
+    BenchResult result;
+    long long switchedBefore = sw->stats.cellsSwitched;
+    double timedNs = 0;
+    counters.reset();
+    while ((result.slots < MIN_SLOTS || timedNs < MIN_TIMED_NS) && result.slots < MAX_SLOTS) {
+        admit();
+        counters.start();
+        steady_clock::time_point start = steady_clock::now();
+        sw->processPackets(time);
+        steady_clock::time_point end = steady_clock::now();
+        counters.stop();
+        timedNs += max(0.0, duration<double, nano>(end - start).count() - overheadNs);
+        sw->phase++;
+        sw->drainOutputs(time);
+        time++;
+        result.slots++;
+    }
+
+    long long matches = sw->stats.cellsSwitched - switchedBefore;
+    result.nsPerDecision = timedNs / result.slots;
+    result.matchesPerDecision = (double)matches / result.slots;
+    result.matchesPerSecond = timedNs > 0 ? matches / (timedNs * 1e-9) : 0;
+    long long cacheMisses, branchMisses;
+    if (counters.read(cacheMisses, branchMisses)) {
+        result.counted = true;
+        result.cacheMisses = (double)cacheMisses / result.slots;
+        result.branchMisses = (double)branchMisses / result.slots;
+    }
+    return result;
+}
+
+typedef BenchResult (*BenchFn)(const Workload& work, PerfCounters& counters, double overheadNs);
+
+struct BenchEntry {
+    const char* name;
+    BenchFn run;
+};
+
+// The VOQ schedulers of the registry; the output-queued reference makes no
+// decisions and is left out
+static const BenchEntry BENCHES[] = {
+    {"islip", &benchScheduler<IslipScheduler>},
+    {"priority", &benchScheduler<PriorityScheduler>},
+    {"rr", &benchScheduler<RoundRobinScheduler>},
+    {"drr", &benchScheduler<DrrScheduler>},
+    {"wfq", &benchScheduler<Wf2qScheduler>},
+    {"pim", &benchScheduler<PimScheduler>},
+    {"drrm", &benchScheduler<DrrmScheduler>},
+    {"wfa", &benchScheduler<WavefrontScheduler>},
+    {"msm", &benchScheduler<MaxSizeScheduler>},
+    {"lqf", &benchScheduler<LqfScheduler>},
+    {"ocf", &benchScheduler<OcfScheduler>},
+    {"ilqf", &benchScheduler<IlqfScheduler>},
+    {"lpf", &benchScheduler<LpfScheduler>},
+};
+
+template <class T>
+static bool parseList(const string& text, vector<T>& values) {
+    values.clear();
+    istringstream list(text);
+    string item;
+    while (getline(list, item, ',')) {
+        istringstream in(item);
+        T value;
+        in >> value;
+        if (!in || !in.eof()) {
+            return false;
+        }
+        values.push_back(value);
+    }
+    return !values.empty();
+}
+
+static void printUsage(const char* program) {
+    cout << "Usage: " << program << " [--ports N,N,...] [--loads L,L,...] [scheduler[,scheduler...]]" << endl;
+    cout << "Times each scheduler's decision per slot on shared pre-generated workloads" << endl;
+    cout << "(default ports 8,32,128,512, loads 0.5,0.8,0.95, every VOQ scheduler)." << endl;
+}
+
+int main(int argc, char* argv[]) {
+    vector<int> portCounts = {8, 32, 128, 512};
+    vector<double> loads = {0.5, 0.8, 0.95};
+    vector<const BenchEntry*> benches;
+    for (const BenchEntry& entry : BENCHES) {
+        benches.push_back(&entry);
+    }
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--ports" && i + 1 < argc) {
+            if (!parseList(argv[++i], portCounts)) {
+                cout << "Error: --ports takes a list of port counts" << endl;
+                return 1;
+            }
+            for (int n : portCounts) {
+                if (n < 1 || n > 4096) {
+                    cout << "Error: port counts must be between 1 and 4096" << endl;
+                    return 1;
+                }
+            }
+        } else if (arg == "--loads" && i + 1 < argc) {
+            if (!parseList(argv[++i], loads)) {
+                cout << "Error: --loads takes a list of loads" << endl;
+                return 1;
+            }
+            for (double load : loads) {
+                if (load <= 0 || load >= 1) {
+                    cout << "Error: loads must be above 0 and below 1" << endl;
+                    return 1;
+                }
+            }
+        } else if (arg.compare(0, 2, "--") != 0) {
+            benches.clear();
+            istringstream list(arg);
+            string name;
+            while (getline(list, name, ',')) {
+                const BenchEntry* found = nullptr;
+                for (const BenchEntry& entry : BENCHES) {
+                    if (name == entry.name) {
+                        found = &entry;
+                    }
+                }
+                if (!found) {
+                    cout << "Unknown scheduler: " << name << endl;
+                    return 1;
+                }
+                benches.push_back(found);
+            }
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    PerfCounters counters;
+    double overheadNs = timerOverheadNs();
+    cout << "Timer overhead " << fixed << setprecision(1) << overheadNs << " ns per call, subtracted" << endl;
+    if (!counters.available()) {
+        cout << "Hardware counters unavailable (perf_event_open refused; see /proc/sys/kernel/perf_event_paranoid)" << endl;
+    }
+    cout << defaultfloat;
+    cout << left << setw(10) << "scheduler" << right << setw(6) << "ports" << setw(6) << "load" << setw(14) << "ns/decision"
+         << setw(14) << "matches/slot" << setw(12) << "Mmatch/s" << setw(14) << "cache-miss" << setw(14) << "branch-miss"
+         << setw(9) << "slots" << endl;
+
+    SimRandom random(RNG_XOSHIRO, 1);
+    for (int n : portCounts) {
+        for (double load : loads) {
+            Workload work = makeWorkload(n, load, random);
+            for (const BenchEntry* bench : benches) {
+                BenchResult result = bench->run(work, counters, overheadNs);
+                cout << left << setw(10) << bench->name << right << setw(6) << n << setw(6) << setprecision(3) << load << fixed
+                     << setprecision(1) << setw(14) << result.nsPerDecision << setw(14) << result.matchesPerDecision
+                     << setprecision(2) << setw(12) << result.matchesPerSecond * 1e-6 << setprecision(1);
+                if (result.counted) {
+                    cout << setw(14) << result.cacheMisses << setw(14) << result.branchMisses;
+                } else {
+                    cout << setw(14) << "n/a" << setw(14) << "n/a";
+                }
+                cout << setw(9) << result.slots << defaultfloat << endl;
+            }
+        }
+    }
+    return 0;
+}
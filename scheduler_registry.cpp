@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <memory>
+#include "scheduler_registry.h"
+#include "islip.h"
+#include "priority_queue_voq.h"
+#include "rr_voq.h"
+#include "wfq_voq.h"
+#include "oq_switch.h"
+#include "pim.h"
+#include "drrm.h"
+#include "wavefront.h"
+#include "hopcroft_karp.h"
+#include "max_weight.h"
+#include "lqf_approx.h"
+
+using namespace std;
+
+template <class Scheduler>
+static RunSummary runSimulation(const SimConfig& config, ostream* out) {
+    unique_ptr<RouterSwitch<Scheduler>> router(new RouterSwitch<Scheduler>(config));
+    router->simulate();
+    const SwitchStats& stats = router->stats;
+    if (out) {
+        stats.print(*out, config.simulationTime);
+        router->scheduler.printStatistics(*out);
+        if (router->profiler) {
+            router->profiler->print(*out, config.simulationTime);
+        }
+    }
+
+    RunSummary summary;
+    summary.arrivals = stats.totalArrivals;
+    summary.processed = stats.packetsProcessed;
+    summary.inputDrops = stats.totalPacketsDropped;
+    summary.outputDrops = stats.outputPacketsDropped;
+    summary.departed = stats.packetsDeparted;
+    summary.throughput = stats.throughput(config.simulationTime);
+    summary.goodput = stats.goodput(config.simulationTime);
+    summary.averageWaiting = stats.waiting().mean();
+    summary.delay = stats.delay();
+    summary.averageOutputDelay = summary.delay.mean();
+    summary.occupancy = config.occupancy;
+    summary.inputOccupancy = stats.inputOccupancy.pooled();
+    summary.voqOccupancy = stats.voqOccupancy.pooled();
+    for (int i = 0; i < stats.inputOccupancy.size(); i++) {
+        summary.inputPeak = max(summary.inputPeak, stats.inputOccupancy.peak(i));
+    }
+    for (int voq = 0; voq < stats.voqOccupancy.size(); voq++) {
+        summary.voqPeak = max(summary.voqPeak, stats.voqOccupancy.peak(voq));
+    }
+    if (router->profiler) {
+        for (int p = 0; p < PROFILE_PHASES; p++) {
+            summary.phaseNanos.push_back(config.simulationTime > 0 ? router->profiler->nanos(p) / config.simulationTime : 0);
+        }
+    }
+    return summary;
+}
+
+const vector<SchedulerEntry>& schedulerRegistry() {
+    static const vector<SchedulerEntry> entries = {
+        {"islip", "iSLIP request/grant/accept", &runSimulation<IslipScheduler>},
+        {"priority", "Strict priority VOQ", &runSimulation<PriorityScheduler>},
+        {"rr", "Round robin VOQ", &runSimulation<RoundRobinScheduler>},
+        {"drr", "Deficit round robin per output", &runSimulation<DrrScheduler>},
+        {"wfq", "Weighted fair queuing per output (WF2Q+)", &runSimulation<Wf2qScheduler>},
+        {"pim", "Parallel iterative matching", &runSimulation<PimScheduler>},
+        {"drrm", "Dual round-robin matching", &runSimulation<DrrmScheduler>},
+        {"wfa", "Wrapped wavefront arbiter", &runSimulation<WavefrontScheduler>},
+        {"msm", "Maximum size matching (Hopcroft-Karp)", &runSimulation<MaxSizeScheduler>},
+        {"lqf", "Maximum weight matching, longest queue first", &runSimulation<LqfScheduler>},
+        {"ocf", "Maximum weight matching, oldest cell first", &runSimulation<OcfScheduler>},
+        {"ilqf", "Iterative longest queue first", &runSimulation<IlqfScheduler>},
+        {"lpf", "Greedy longest port first", &runSimulation<LpfScheduler>},
+        {"oq", "Output-queued reference switch", &runSimulation<OutputQueuedScheduler>},
+    };
+    return entries;
+}
+
+const SchedulerEntry* findScheduler(const string& name) {
+    for (const SchedulerEntry& entry : schedulerRegistry()) {
+        if (name == entry.name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
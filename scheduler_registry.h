@@ -0,0 +1,51 @@
+#ifndef SCHEDULER_REGISTRY_H
+#define SCHEDULER_REGISTRY_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "latency_histogram.h"
+#include "phase_profiler.h"
+#include "sim_config.h"
+
+// Headline numbers of one run; a sweep writes one of these per grid point
+struct RunSummary {
+    long long arrivals = 0;
+    long long processed = 0;
+    long long inputDrops = 0;
+    long long outputDrops = 0;
+    long long departed = 0;
+    double throughput = 0;     // Cells sent per output per slot
+    double goodput = 0;        // Share of the output link capacity carrying packet data
+    double averageWaiting = 0; // Slots spent in the VOQs
+    double averageOutputDelay = 0;
+    // Arrival to departure of every departed packet. Histograms of runs
+    // merge into pooled percentiles, whichever threads ran them.
+    LatencyHistogram delay;
+    // Cells buffered per input and per VOQ at the end of every slot, pooled
+    // over the inputs and the VOQs, and the highest level any of them
+    // reached; only filled with config.occupancy
+    bool occupancy = false;
+    LatencyHistogram inputOccupancy;
+    LatencyHistogram voqOccupancy;
+    int inputPeak = 0;
+    int voqPeak = 0;
+    // Nanoseconds per slot in each ProfilePhase; empty unless config.profile
+    std::vector<double> phaseNanos;
+};
+
+// Runs one full simulation with the scheduler. Everything random comes from
+// streams of config.seed, so a run is reproducible and safe to run on any
+// thread. Prints the full statistics to out unless out is null.
+typedef RunSummary (*RunSimulationFn)(const SimConfig& config, std::ostream* out);
+
+struct SchedulerEntry {
+    const char* name;
+    const char* description;
+    RunSimulationFn run;
+};
+
+const std::vector<SchedulerEntry>& schedulerRegistry();
+const SchedulerEntry* findScheduler(const std::string& name);
+
+#endif
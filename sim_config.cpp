@@ -0,0 +1,460 @@
+#include <fstream>
+#include <sstream>
+#include "sim_config.h"
+#include "voq_buffer.h"
+
+using namespace std;
+
+static bool parseInt(const string& text, int& value) {
+    istringstream in(text);
+    in >> value;
+    return in && in.eof();
+}
+
+static bool parseDouble(const string& text, double& value) {
+    istringstream in(text);
+    in >> value;
+    return in && in.eof();
+}
+
+vector<double> SimConfig::drainRates() const {
+    vector<double> rates(numPorts, drainRate);
+    for (const pair<int, double>& portRate : portDrainRates) {
+        rates[portRate.first] = portRate.second;
+    }
+    return rates;
+}
+
+const char* trafficName(TrafficPattern traffic) {
+    switch (traffic) {
+    case TRAFFIC_NON_UNIFORM:
+        return "non_uniform";
+    case TRAFFIC_BURSTY:
+        return "bursty";
+    case TRAFFIC_BERNOULLI:
+        return "bernoulli";
+    case TRAFFIC_POISSON:
+        return "poisson";
+    case TRAFFIC_ON_OFF:
+        return "on_off";
+    case TRAFFIC_TRACE:
+        return "trace";
+    default:
+        return "uniform";
+    }
+}
+
+const char* rngName(RandomEngine rng) {
+    switch (rng) {
+    case RNG_PCG:
+        return "pcg";
+    case RNG_PHILOX:
+        return "philox";
+    default:
+        return "xoshiro";
+    }
+}
+
+const char* destinationName(DestinationPattern destinations) {
+    switch (destinations) {
+    case DEST_HOTSPOT:
+        return "hotspot";
+    case DEST_DIAGONAL:
+        return "diagonal";
+    case DEST_LOG_DIAGONAL:
+        return "log_diagonal";
+    case DEST_UNBALANCED:
+        return "unbalanced";
+    case DEST_FILE:
+        return "file";
+    default:
+        return "uniform";
+    }
+}
+
+// Every key that setConfigValue parses as one number; a new numeric key
+// goes here too, or sweeps only take it as a list
+static const char* const NUMERIC_KEYS[] = {
+    "seed", "hotspot_fraction", "omega", "packet_mode", "metrics_voqs", "profile", "occupancy", "burst_length",
+    "load", "speedup", "drain", "ports", "buffer", "slots", "rate", "output_buffer", "islip_iterations",
+    "pim_iterations", "ilqf_iterations", "quantum", "threads", "hotspots", "cell_size", "trace_slot_ns",
+    "metrics_interval"};
+
+bool isNumericConfigKey(const string& key) {
+    for (const char* numeric : NUMERIC_KEYS) {
+        if (key == numeric) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool setConfigValue(SimConfig& config, const string& key, const string& value, string& error) {
+    // Traffic patterns by name, or by the numbers of the old interactive menu
+    if (key == "traffic") {
+        if (value == "uniform" || value == "1") {
+            config.traffic = TRAFFIC_UNIFORM;
+        } else if (value == "non_uniform" || value == "2") {
+            config.traffic = TRAFFIC_NON_UNIFORM;
+        } else if (value == "bursty" || value == "3") {
+            config.traffic = TRAFFIC_BURSTY;
+        } else if (value == "bernoulli") {
+            config.traffic = TRAFFIC_BERNOULLI;
+        } else if (value == "poisson") {
+            config.traffic = TRAFFIC_POISSON;
+        } else if (value == "on_off") {
+            config.traffic = TRAFFIC_ON_OFF;
+        } else if (value == "trace") {
+            config.traffic = TRAFFIC_TRACE;
+        } else {
+            error = "bad value '" + value + "' for '" + key + "', expected uniform, non_uniform, bursty, bernoulli, poisson, on_off or trace";
+            return false;
+        }
+        return true;
+    }
+    if (key == "rng") {
+        if (value == "xoshiro") {
+            config.rng = RNG_XOSHIRO;
+        } else if (value == "pcg") {
+            config.rng = RNG_PCG;
+        } else if (value == "philox") {
+            config.rng = RNG_PHILOX;
+        } else {
+            error = "bad value '" + value + "' for '" + key + "', expected xoshiro, pcg or philox";
+            return false;
+        }
+        return true;
+    }
+    if (key == "seed") {
+        istringstream in(value);
+        in >> config.seed;
+        if (!in || !in.eof() || value[0] == '-') {
+            error = "bad value '" + value + "' for '" + key + "'";
+            return false;
+        }
+        return true;
+    }
+    if (key == "destinations") {
+        if (value == "uniform") {
+            config.destinations = DEST_UNIFORM;
+        } else if (value == "hotspot") {
+            config.destinations = DEST_HOTSPOT;
+        } else if (value == "diagonal") {
+            config.destinations = DEST_DIAGONAL;
+        } else if (value == "log_diagonal") {
+            config.destinations = DEST_LOG_DIAGONAL;
+        } else if (value == "unbalanced") {
+            config.destinations = DEST_UNBALANCED;
+        } else if (value == "file") {
+            config.destinations = DEST_FILE;
+        } else {
+            error = "bad value '" + value + "' for '" + key + "', expected uniform, hotspot, diagonal, log_diagonal, unbalanced or file";
+            return false;
+        }
+        return true;
+    }
+    if (key == "destination_file") {
+        config.destinationFile = value;
+        config.destinations = DEST_FILE;
+        return true;
+    }
+    if (key == "trace_file") {
+        config.traceFile = value;
+        config.traffic = TRAFFIC_TRACE;
+        return true;
+    }
+    if (key == "hotspot_fraction" || key == "omega") {
+        if (!parseDouble(value, key == "omega" ? config.unbalancedOmega : config.hotspotFraction)) {
+            error = "bad value '" + value + "' for '" + key + "'";
+            return false;
+        }
+        return true;
+    }
+    if (key == "metrics_file") {
+        config.metricsFile = value;
+        return true;
+    }
+    if (key == "event_file") {
+        config.eventFile = value;
+        return true;
+    }
+    if (key == "metrics_format") {
+        if (value == "csv") {
+            config.metricsFormat = METRICS_CSV;
+        } else if (value == "jsonl") {
+            config.metricsFormat = METRICS_JSONL;
+        } else {
+            error = "bad value '" + value + "' for '" + key + "', expected csv or jsonl";
+            return false;
+        }
+        return true;
+    }
+    if (key == "packet_mode" || key == "metrics_voqs" || key == "profile" || key == "occupancy") {
+        bool& flag = key == "packet_mode" ? config.packetMode : key == "metrics_voqs" ? config.metricsVoqs
+                     : key == "profile" ? config.profile : config.occupancy;
+        if (value == "1" || value == "true") {
+            flag = true;
+        } else if (value == "0" || value == "false") {
+            flag = false;
+        } else {
+            error = "bad value '" + value + "' for '" + key + "', expected 0 or 1";
+            return false;
+        }
+        return true;
+    }
+    if (key == "burst_length") {
+        if (!parseDouble(value, config.burstLength)) {
+            error = "bad value '" + value + "' for '" + key + "'";
+            return false;
+        }
+        return true;
+    }
+    if (key == "load") {
+        if (!parseDouble(value, config.load)) {
+            error = "bad value '" + value + "' for '" + key + "'";
+            return false;
+        }
+        return true;
+    }
+    if (key == "speedup") {
+        if (!parseDouble(value, config.speedup)) {
+            error = "bad value '" + value + "' for '" + key + "'";
+            return false;
+        }
+        return true;
+    }
+    if (key == "drain") {
+        if (!parseDouble(value, config.drainRate)) {
+            error = "bad value '" + value + "' for '" + key + "'";
+            return false;
+        }
+        return true;
+    }
+    // "port_drain = P:R" sets output port P's rate to R
+    if (key == "port_drain") {
+        size_t colon = value.find(':');
+        int port;
+        double rate;
+        if (colon == string::npos || !parseInt(value.substr(0, colon), port) || !parseDouble(value.substr(colon + 1), rate)) {
+            error = "bad value '" + value + "' for '" + key + "', expected PORT:RATE";
+            return false;
+        }
+        config.portDrainRates.push_back(make_pair(port, rate));
+        return true;
+    }
+
+    if (key == "weights") {
+        config.weightsFile = value;
+        return true;
+    }
+
+    int* target = nullptr;
+    if (key == "ports") {
+        target = &config.numPorts;
+    } else if (key == "buffer") {
+        target = &config.bufferSize;
+    } else if (key == "slots") {
+        target = &config.simulationTime;
+    } else if (key == "rate") {
+        target = &config.arrivalRate;
+    } else if (key == "output_buffer") {
+        target = &config.outputBufferSize;
+    } else if (key == "islip_iterations") {
+        target = &config.islipIterations;
+    } else if (key == "pim_iterations") {
+        target = &config.pimIterations;
+    } else if (key == "ilqf_iterations") {
+        target = &config.ilqfIterations;
+    } else if (key == "quantum") {
+        target = &config.quantum;
+    } else if (key == "threads") {
+        target = &config.threads;
+    } else if (key == "hotspots") {
+        target = &config.hotspots;
+    } else if (key == "cell_size") {
+        target = &config.cellSize;
+    } else if (key == "trace_slot_ns") {
+        target = &config.traceSlotNanos;
+    } else if (key == "metrics_interval") {
+        target = &config.metricsInterval;
+    } else {
+        error = "unknown setting '" + key + "'";
+        return false;
+    }
+    if (!parseInt(value, *target)) {
+        error = "bad value '" + value + "' for '" + key + "'";
+        return false;
+    }
+    return true;
+}
+
+// Config files hold one "key = value" per line; '#' starts a comment
+bool loadConfigFile(SimConfig& config, const string& path, string& error) {
+    ifstream in(path);
+    if (!in) {
+        error = "cannot open config file '" + path + "'";
+        return false;
+    }
+    string line;
+    int lineNumber = 0;
+    while (getline(in, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+        size_t equals = line.find('=');
+        string key, value;
+        istringstream(line.substr(0, equals)) >> key;
+        if (key.empty()) {
+            continue;
+        }
+        if (equals != string::npos) {
+            istringstream(line.substr(equals + 1)) >> value;
+        }
+        if (!setConfigValue(config, key, value, error)) {
+            error = path + ":" + to_string(lineNumber) + ": " + error;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool validateConfig(const SimConfig& config, string& error) {
+    if (config.numPorts < 1 || config.numPorts > MAX_PORTS) {
+        error = "ports must be between 1 and " + to_string(MAX_PORTS);
+    } else if (config.bufferSize < 1 || config.bufferSize > MAX_BUFFER_SIZE) {
+        error = "buffer must be between 1 and " + to_string(MAX_BUFFER_SIZE);
+    } else if (config.simulationTime < 0) {
+        error = "slots must not be negative";
+    } else if (config.arrivalRate < 0) {
+        error = "rate must not be negative";
+    } else if (config.load > 1000) {
+        error = "load must be at most 1000";
+    } else if (config.traffic == TRAFFIC_BERNOULLI && config.meanArrivals() > 1) {
+        error = "bernoulli traffic needs a load of at most 1";
+    } else if (config.traffic == TRAFFIC_ON_OFF && config.meanArrivals() > 1) {
+        error = "on_off traffic needs a load of at most 1";
+    } else if (config.burstLength < 1) {
+        error = "burst_length must be at least 1";
+    } else if (config.hotspots < 1 || config.hotspots > config.numPorts) {
+        error = "hotspots must be between 1 and the number of ports";
+    } else if (config.hotspotFraction < 0 || config.hotspotFraction > 1) {
+        error = "hotspot_fraction must be between 0 and 1";
+    } else if (config.unbalancedOmega < 0 || config.unbalancedOmega > 1) {
+        error = "omega must be between 0 and 1";
+    } else if (config.destinations == DEST_FILE && config.destinationFile.empty()) {
+        error = "file destinations need a destination_file";
+    } else if (config.traffic == TRAFFIC_TRACE && config.traceFile.empty()) {
+        error = "trace traffic needs a trace_file";
+    } else if (config.traceSlotNanos < 1) {
+        error = "trace_slot_ns must be at least 1";
+    } else if (config.traffic == TRAFFIC_POISSON && config.meanArrivals() > 100) {
+        error = "poisson traffic needs a load of at most 100";
+    } else if (config.speedup < 1 || config.speedup > 64) {
+        error = "speedup must be between 1 and 64";
+    } else if (config.cellSize < 0) {
+        error = "cell_size must not be negative";
+    } else if (config.packetMode && config.cellSize == 0) {
+        error = "packet_mode needs a cell_size";
+    } else if (config.metricsInterval < 1) {
+        error = "metrics_interval must be at least 1";
+    } else if (config.outputBufferSize < 1) {
+        error = "output_buffer must be at least 1";
+    } else if (config.drainRate < 0) {
+        error = "drain must not be negative";
+    } else if (config.islipIterations < 0) {
+        error = "islip_iterations must not be negative";
+    } else if (config.pimIterations < 0) {
+        error = "pim_iterations must not be negative";
+    } else if (config.ilqfIterations < 0) {
+        error = "ilqf_iterations must not be negative";
+    } else if (config.quantum < 1) {
+        error = "quantum must be at least 1";
+    } else if (config.threads < 0) {
+        error = "threads must not be negative";
+    } else {
+        for (const pair<int, double>& portRate : config.portDrainRates) {
+            if (portRate.first < 0 || portRate.first >= config.numPorts) {
+                error = "port_drain port " + to_string(portRate.first) + " is out of range";
+                return false;
+            }
+            if (portRate.second < 0) {
+                error = "port_drain rate must not be negative";
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+bool loadVoqWeights(SimConfig& config, string& error) {
+    config.voqWeights.clear();
+    if (config.weightsFile.empty()) {
+        return true;
+    }
+    ifstream in(config.weightsFile);
+    if (!in) {
+        error = "cannot open weights file '" + config.weightsFile + "'";
+        return false;
+    }
+    int weight;
+    while (in >> weight) {
+        if (weight < 1) {
+            error = config.weightsFile + ": weights must be at least 1";
+            return false;
+        }
+        config.voqWeights.push_back(weight);
+    }
+    if (!in.eof() || (int)config.voqWeights.size() != config.numPorts * config.numPorts) {
+        error = config.weightsFile + ": expected " + to_string(config.numPorts) + " x " + to_string(config.numPorts) + " integer weights";
+        return false;
+    }
+    return true;
+}
+
+bool loadDestinationMatrix(SimConfig& config, string& error) {
+    config.destinationMatrix.clear();
+    if (config.destinations != DEST_FILE) {
+        return true;
+    }
+    ifstream in(config.destinationFile);
+    if (!in) {
+        error = "cannot open destination file '" + config.destinationFile + "'";
+        return false;
+    }
+    double rate;
+    while (in >> rate) {
+        if (rate < 0) {
+            error = config.destinationFile + ": rates must not be negative";
+            return false;
+        }
+        config.destinationMatrix.push_back(rate);
+    }
+    int n = config.numPorts;
+    if (!in.eof() || (int)config.destinationMatrix.size() != n * n) {
+        error = config.destinationFile + ": expected " + to_string(n) + " x " + to_string(n) + " rates";
+        return false;
+    }
+    for (int i = 0; i < n; i++) {
+        double total = 0;
+        for (int j = 0; j < n; j++) {
+            total += config.destinationMatrix[i * n + j];
+        }
+        if (total <= 0) {
+            error = config.destinationFile + ": row " + to_string(i) + " has no positive rate";
+            return false;
+        }
+    }
+    return true;
+}
+
+string taggedPath(const string& path, const string& tag) {
+    if (tag.empty()) {
+        return path;
+    }
+    size_t dot = path.rfind('.');
+    size_t slash = path.find_last_of("/\\");
+    if (dot == string::npos || dot == 0 || (slash != string::npos && dot < slash + 2)) {
+        dot = path.size();
+    }
+    return path.substr(0, dot) + "." + tag + path.substr(dot);
+}
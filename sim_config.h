@@ -0,0 +1,129 @@
+#ifndef SIM_CONFIG_H
+#define SIM_CONFIG_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "sim_random.h"
+
+enum TrafficPattern {
+    TRAFFIC_UNIFORM = 1,
+    TRAFFIC_NON_UNIFORM = 2,
+    TRAFFIC_BURSTY = 3,
+    TRAFFIC_BERNOULLI = 4, // One packet per input per slot with probability load
+    TRAFFIC_POISSON = 5,   // Poisson batches with mean load per input per slot
+    TRAFFIC_ON_OFF = 6,    // Markov ON/OFF bursts, each to a single output
+    TRAFFIC_TRACE = 7      // Replay of a binary packet trace
+};
+
+// The engine sizes its VOQ arrays as numPorts * numPorts ints
+const int MAX_PORTS = 4096;
+
+class TraceFile;
+class MetricsWriter;
+class EventTracer;
+
+enum MetricsFormat {
+    METRICS_CSV = 0,
+    METRICS_JSONL = 1 // One JSON object per line
+};
+
+// How each input spreads its packets over the outputs
+enum DestinationPattern {
+    DEST_UNIFORM = 0,
+    DEST_HOTSPOT = 1,      // A share of every input's traffic to the first outputs
+    DEST_DIAGONAL = 2,     // Input i: 2/3 to output i, 1/3 to output i + 1
+    DEST_LOG_DIAGONAL = 3, // Input i: output i + k gets twice the share of output i + k + 1
+    DEST_UNBALANCED = 4,   // Input i: omega to output i, the rest uniform
+    DEST_FILE = 5          // Rows of a numPorts x numPorts rate matrix
+};
+
+// Run-time parameters of one simulation
+struct SimConfig {
+    int numPorts = 8;          // Input and output ports of the switch
+    int bufferSize = 64;       // Maximum cells per VOQ
+    int simulationTime = 1000; // Number of time units to run the simulation
+    int arrivalRate = 4;       // Packets arriving per unit time (uniform traffic)
+    double load = -1;          // Mean packets per input per slot; negative = use arrivalRate
+    TrafficPattern traffic = TRAFFIC_UNIFORM;
+    double burstLength = 16;   // Mean packets per ON period (on_off traffic)
+    std::string traceFile;     // Binary trace replayed by trace traffic
+    int traceSlotNanos = 1000; // Trace nanoseconds per time slot
+    std::shared_ptr<const TraceFile> trace; // Mapped from traceFile, shared by every run
+
+    // Destinations
+    DestinationPattern destinations = DEST_UNIFORM;
+    int hotspots = 1;              // Hotspot outputs, ports 0 .. hotspots - 1
+    double hotspotFraction = 0.5;  // Share of each input's traffic sent to the hotspots
+    double unbalancedOmega = 0.5;  // Unbalance of DEST_UNBALANCED, 0 = uniform, 1 = diagonal
+    std::string destinationFile;   // numPorts x numPorts rates for DEST_FILE, one row per input
+    std::vector<double> destinationMatrix; // Loaded from destinationFile, input * numPorts + output
+    uint64_t seed = 0;         // Random streams of a run derive from this; main replaces 0 with the clock
+    RandomEngine rng = RNG_XOSHIRO;
+
+    // Fabric
+    double speedup = 1.0;      // Scheduling phases per slot, may be fractional
+
+    // Segmentation
+    int cellSize = 0;          // Size units per fabric cell, 0 = every packet crosses as one cell
+    bool packetMode = false;   // Hold a match until the packet's last cell has crossed
+
+    // Egress stage
+    int outputBufferSize = 64; // Maximum cells per output queue
+    double drainRate = 1.0;    // Cells each output sends per unit time
+    std::vector<std::pair<int, double>> portDrainRates; // Per-port overrides of drainRate
+
+    // Scheduler tuning
+    int islipIterations = 1; // iSLIP request/grant/accept rounds per slot, 0 = until no new match
+    int pimIterations = 1;   // PIM rounds per slot, 0 = until no new match
+    int ilqfIterations = 1;  // iLQF rounds per slot, 0 = until no new match
+    int quantum = 10;        // DRR credit per unit of VOQ weight per round
+    std::string weightsFile; // numPorts x numPorts VOQ weights for DRR/WFQ, one row per input
+    std::vector<int> voqWeights; // Loaded from weightsFile, input * numPorts + output; empty = all 1
+
+    // Interval metrics
+    std::string metricsFile;   // Time series written during the run, none if empty
+    int metricsInterval = 1000; // Slots per row
+    MetricsFormat metricsFormat = METRICS_CSV;
+    bool metricsVoqs = false;  // Add the cells queued in every VOQ to each row
+    std::shared_ptr<MetricsWriter> metrics; // Opened from metricsFile for a single run
+
+    // Time spent in each phase of the slot loop, reported with the results
+    bool profile = false;
+    // Time-weighted buffer occupancy, peaks and histograms per input and VOQ
+    bool occupancy = false;
+
+    // Scheduling event trace
+    std::string eventFile;     // Binary events written during the run, none if empty
+    std::shared_ptr<EventTracer> events; // Opened from eventFile for a single run
+
+    // Sweeps
+    int threads = 0;         // Worker threads, 0 = one per hardware thread
+
+    std::vector<double> drainRates() const;
+    // Mean packets arriving per input per slot
+    double meanArrivals() const { return load >= 0 ? load : arrivalRate; }
+    // Cells a packet of the given size is cut into
+    int cellsPerPacket(int size) const { return cellSize > 0 ? (size + cellSize - 1) / cellSize : 1; }
+};
+
+const char* trafficName(TrafficPattern traffic);
+const char* rngName(RandomEngine rng);
+const char* destinationName(DestinationPattern destinations);
+
+// Both return false and fill error on a bad key or value
+bool setConfigValue(SimConfig& config, const std::string& key, const std::string& value, std::string& error);
+bool loadConfigFile(SimConfig& config, const std::string& path, std::string& error);
+bool validateConfig(const SimConfig& config, std::string& error);
+// True for keys whose value is a single number, which a sweep may give as a range
+bool isNumericConfigKey(const std::string& key);
+// Read the files named by the config once the port count is final:
+// weightsFile into voqWeights, destinationFile into destinationMatrix
+bool loadVoqWeights(SimConfig& config, std::string& error);
+bool loadDestinationMatrix(SimConfig& config, std::string& error);
+// path with ".tag" put ahead of its extension, or path itself for no tag
+std::string taggedPath(const std::string& path, const std::string& tag);
+
+#endif
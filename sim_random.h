@@ -0,0 +1,274 @@
+#ifndef SIM_RANDOM_H
+#define SIM_RANDOM_H
+
+#include <cmath>
+#include <cstdint>
+
+// Random streams used inside a simulation, in place of the global rand().
+// Each run owns its generators, so runs can share a process or a thread pool
+// without touching common state.
+enum RandomStream {
+    STREAM_TRAFFIC = 0,   // Arrivals and packet fields
+    STREAM_SCHEDULER = 1  // Random choices made by schedulers such as PIM
+};
+
+// Generator behind a SimRandom, picked at run time with the rng setting
+enum RandomEngine {
+    RNG_XOSHIRO = 0, // xoshiro256++: fastest, 256-bit state
+    RNG_PCG = 1,     // PCG32 (XSH-RR): 64-bit LCG with a permuted output
+    RNG_PHILOX = 2   // Philox4x32-10: counter-based, keyed by the seed
+};
+
+// SplitMix64 finalizer; also expands one seed into engine state
+inline uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+struct Xoshiro256pp {
+    uint64_t s[4];
+
+    explicit Xoshiro256pp(uint64_t seed) {
+        for (int i = 0; i < 4; i++) {
+            s[i] = splitMix64(seed);
+        }
+    }
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    // count 32-bit words, low half of each output first; count is even
+    void fill(uint32_t* out, int count) {
+        uint64_t s0 = s[0], s1 = s[1], s2 = s[2], s3 = s[3];
+        for (int i = 0; i < count; i += 2) {
+            uint64_t result = rotl(s0 + s3, 23) + s0;
+            out[i] = (uint32_t)result;
+            out[i + 1] = (uint32_t)(result >> 32);
+            uint64_t t = s1 << 17;
+            s2 ^= s0;
+            s3 ^= s1;
+            s1 ^= s2;
+            s0 ^= s3;
+            s2 ^= t;
+            s3 = rotl(s3, 45);
+        }
+        s[0] = s0; s[1] = s1; s[2] = s2; s[3] = s3;
+    }
+};
+
+struct Pcg32 {
+    uint64_t state;
+    uint64_t increment; // Odd; selects the stream
+
+    explicit Pcg32(uint64_t seed) {
+        uint64_t mixer = seed;
+        increment = splitMix64(mixer) | 1;
+        state = 0;
+        step();
+        state += splitMix64(mixer);
+        step();
+    }
+
+    uint32_t step() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ull + increment;
+        uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+        uint32_t rot = (uint32_t)(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+
+    void fill(uint32_t* out, int count) {
+        for (int i = 0; i < count; i++) {
+            out[i] = step();
+        }
+    }
+};
+
+// Philox4x32-10 (Salmon et al., SC'11). Output block n is a keyed bijection of
+// the counter n, so a stream needs no state beyond its key and position.
+struct Philox4x32 {
+    uint32_t key[2];
+    uint64_t counter = 0;
+
+    explicit Philox4x32(uint64_t seed) {
+        key[0] = (uint32_t)seed;
+        key[1] = (uint32_t)(seed >> 32);
+    }
+
+    // count is a multiple of 4, one counter block each
+    void fill(uint32_t* out, int count) {
+        for (int i = 0; i < count; i += 4) {
+            uint32_t c0 = (uint32_t)counter, c1 = (uint32_t)(counter >> 32), c2 = 0, c3 = 0;
+            uint32_t k0 = key[0], k1 = key[1];
+            for (int round = 0; round < 10; round++) {
+                uint64_t p0 = (uint64_t)0xD2511F53u * c0;
+                uint64_t p1 = (uint64_t)0xCD9E8D57u * c2;
+                uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+                uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+                c0 = n0;
+                c1 = (uint32_t)p1;
+                c2 = n2;
+                c3 = (uint32_t)p0;
+                k0 += 0x9E3779B9u;
+                k1 += 0xBB67AE85u;
+            }
+            out[i] = c0;
+            out[i + 1] = c1;
+            out[i + 2] = c2;
+            out[i + 3] = c3;
+            counter++;
+        }
+    }
+};
+
+// A stream of random numbers from one of the engines. Numbers are generated
+// a block of 32-bit words at a time into a buffer, so the engine switch is
+// paid once per block and each engine's loop runs without branches.
+class SimRandom {
+public:
+    static const int BLOCK = 128; // Words per refill, a multiple of 4 for Philox
+
+    SimRandom(RandomEngine engine, uint64_t seed)
+        : engine(engine), xoshiro(seed), pcg(seed), philox(seed) {}
+
+    // Seed of stream number stream of a run with the given seed. Mixing both
+    // keeps the streams of one run apart and those of nearby seeds unrelated.
+    static uint64_t streamSeed(uint64_t seed, uint64_t stream) {
+        uint64_t mixer = seed;
+        mixer = splitMix64(mixer) ^ stream;
+        return splitMix64(mixer);
+    }
+
+    uint32_t next32() {
+        if (position == BLOCK) {
+            refill();
+        }
+        return buffer[position++];
+    }
+
+    uint64_t next() {
+        uint64_t high = next32();
+        return (high << 32) | next32();
+    }
+
+    // count raw 32-bit words into out
+    void words(uint32_t* out, int count) {
+        for (int i = 0; i < count; i++) {
+            if (position == BLOCK) {
+                refill();
+            }
+            out[i] = buffer[position++];
+        }
+    }
+
+    // Integer in [0, n); n > 0. Lemire's multiply-shift with rejection, so
+    // every value is equally likely and there is almost never a division.
+    int uniformInt(int n) {
+        uint64_t product = (uint64_t)next32() * (uint32_t)n;
+        if ((uint32_t)product < (uint32_t)n) {
+            uint32_t threshold = (uint32_t)-(uint32_t)n % (uint32_t)n;
+            while ((uint32_t)product < threshold) {
+                product = (uint64_t)next32() * (uint32_t)n;
+            }
+        }
+        return (int)(product >> 32);
+    }
+
+    // count integers in [0, n) into out, consuming whole buffered blocks.
+    // The block loop works on locals so stores to out cannot alias position.
+    void uniformInts(int* out, int count, int n) {
+        int i = 0;
+        while (i < count) {
+            if (position == BLOCK) {
+                refill();
+            }
+            int start = position;
+            int take = count - i < BLOCK - start ? count - i : BLOCK - start;
+            const uint32_t* words = buffer + start;
+            int* values = out + i;
+            // Only values whose low half is below n can be biased; for those
+            // the exact test needs a division, so it waits for the slow path
+            uint32_t suspect = 0;
+            for (int k = 0; k < take; k++) {
+                uint64_t product = (uint64_t)words[k] * (uint32_t)n;
+                values[k] = (int)(product >> 32);
+                suspect |= (uint32_t)product < (uint32_t)n;
+            }
+            position = start + take;
+            if (suspect) {
+                // Rare: redraw the biased values one at a time. The block is
+                // copied first because a redraw may refill the buffer.
+                uint32_t threshold = (uint32_t)-(uint32_t)n % (uint32_t)n;
+                uint32_t drawn[BLOCK];
+                for (int k = 0; k < take; k++) {
+                    drawn[k] = words[k];
+                }
+                for (int k = 0; k < take; k++) {
+                    if ((uint32_t)((uint64_t)drawn[k] * (uint32_t)n) < threshold) {
+                        values[k] = uniformInt(n);
+                    }
+                }
+            }
+            i += take;
+        }
+    }
+
+    // Double in [0, 1) with 53 random bits
+    double uniform() {
+        return (next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // Probability p, from one 32-bit word
+    bool bernoulli(double p) {
+        return next32() * (1.0 / 4294967296.0) < p;
+    }
+
+    // Failures before the first success of trials that succeed with
+    // probability p, given logFailure = log(1 - p) with 0 < p <= 1. One draw
+    // by inversion, however long the gap; capped at 2^62.
+    long long geometric(double logFailure) {
+        double gap = std::floor(std::log1p(-uniform()) / logFailure);
+        return gap < 4611686018427387904.0 ? (long long)gap : 4611686018427387904LL;
+    }
+
+    // Poisson with the given mean, conditioned on being at least 1;
+    // expNegMean = exp(-mean). Inversion from the bottom, so O(mean).
+    int positivePoisson(double mean, double expNegMean) {
+        double u = expNegMean + uniform() * (1 - expNegMean);
+        double probability = expNegMean;
+        double cumulative = probability;
+        int k = 0;
+        while (u > cumulative && probability > 0) {
+            k++;
+            probability *= mean / k;
+            cumulative += probability;
+        }
+        return k > 0 ? k : 1;
+    }
+
+private:
+    void refill() {
+        switch (engine) {
+        case RNG_PCG:
+            pcg.fill(buffer, BLOCK);
+            break;
+        case RNG_PHILOX:
+            philox.fill(buffer, BLOCK);
+            break;
+        default:
+            xoshiro.fill(buffer, BLOCK);
+            break;
+        }
+        position = 0;
+    }
+
+    RandomEngine engine;
+    Xoshiro256pp xoshiro;
+    Pcg32 pcg;
+    Philox4x32 philox;
+    uint32_t buffer[BLOCK];
+    int position = BLOCK;
+};
+
+#endif
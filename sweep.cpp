@@ -0,0 +1,195 @@
+#include <cmath>
+#include <mutex>
+#include <sstream>
+#include "sweep.h"
+#include "trace_file.h"
+#include "work_pool.h"
+
+using namespace std;
+
+// Shortest text that reads back as the same value, so 0.3 stays "0.3"
+static string formatNumber(double value) {
+    ostringstream text;
+    text.precision(15);
+    text << value;
+    return text.str();
+}
+
+bool parseSweepAxis(const string& text, SweepAxis& axis, string& error) {
+    size_t equals = text.find('=');
+    if (equals == string::npos || equals == 0 || equals + 1 == text.size()) {
+        error = "bad sweep '" + text + "', expected KEY=VALUES";
+        return false;
+    }
+    axis.key = text.substr(0, equals);
+    axis.values.clear();
+    if (axis.key == "config" || axis.key == "port_drain" || axis.key == "metrics_file" || axis.key == "event_file") {
+        error = "cannot sweep '" + axis.key + "'";
+        return false;
+    }
+
+    string spec = text.substr(equals + 1);
+    if (isNumericConfigKey(axis.key) && spec.find(':') != string::npos) {
+        double first, last, step;
+        char colon1, colon2;
+        istringstream in(spec);
+        in >> first >> colon1 >> last >> colon2 >> step;
+        if (!in || colon1 != ':' || colon2 != ':' || !(in >> ws).eof() || step <= 0 || last < first) {
+            error = "bad sweep range '" + spec + "' for '" + axis.key + "', expected FIRST:LAST:STEP";
+            return false;
+        }
+        // Count the steps up front so rounding cannot add or drop the last value
+        long long steps = (long long)floor((last - first) / step + 1e-9);
+        for (long long n = 0; n <= steps; n++) {
+            double value = first + n * step;
+            axis.values.push_back(formatNumber(fabs(value) < 1e-12 ? 0 : value));
+        }
+    } else {
+        istringstream in(spec);
+        string value;
+        while (getline(in, value, ',')) {
+            if (value.empty()) {
+                error = "empty value in sweep '" + text + "'";
+                return false;
+            }
+            axis.values.push_back(value);
+        }
+    }
+    return true;
+}
+
+vector<SweepPoint> expandSweep(const vector<const SchedulerEntry*>& schedulers, const vector<SweepAxis>& axes) {
+    vector<SweepPoint> points;
+    for (const SchedulerEntry* scheduler : schedulers) {
+        // Odometer over the axes, last axis fastest
+        vector<size_t> position(axes.size(), 0);
+        while (true) {
+            SweepPoint point;
+            point.scheduler = scheduler;
+            for (size_t a = 0; a < axes.size(); a++) {
+                point.values.push_back(axes[a].values[position[a]]);
+            }
+            points.push_back(point);
+
+            size_t a = axes.size();
+            while (a > 0 && ++position[a - 1] == axes[a - 1].values.size()) {
+                position[--a] = 0;
+            }
+            if (a == 0) {
+                break;
+            }
+        }
+    }
+    return points;
+}
+
+// seed is the master seed column, empty when a seed axis gives it;
+// occupancy and profiled add the buffer occupancy and the phase times, left
+// blank for points run without them
+static void writeRow(ostream& out, const SweepPoint& point, const RunSummary& summary, const string& seed,
+                     bool occupancy, bool profiled) {
+    out << point.scheduler->name;
+    for (const string& value : point.values) {
+        out << "," << value;
+    }
+    if (!seed.empty()) {
+        out << "," << seed;
+    }
+    out << "," << summary.arrivals << "," << summary.processed << "," << summary.inputDrops
+        << "," << summary.outputDrops << "," << summary.departed << "," << summary.throughput
+        << "," << summary.goodput << "," << summary.averageWaiting << "," << summary.averageOutputDelay
+        << "," << summary.delay.percentile(0.5) << "," << summary.delay.percentile(0.99)
+        << "," << summary.delay.percentile(0.999) << "," << summary.delay.max();
+    if (occupancy && summary.occupancy) {
+        out << "," << summary.inputOccupancy.mean() << "," << summary.inputOccupancy.percentile(0.99)
+            << "," << summary.inputPeak << "," << summary.voqOccupancy.percentile(0.99) << "," << summary.voqPeak;
+    } else if (occupancy) {
+        out << ",,,,,";
+    }
+    if (profiled) {
+        double total = 0;
+        for (int p = 0; p < PROFILE_PHASES; p++) {
+            out << ",";
+            if (!summary.phaseNanos.empty()) {
+                out << summary.phaseNanos[p];
+                total += summary.phaseNanos[p];
+            }
+        }
+        out << ",";
+        if (!summary.phaseNanos.empty()) {
+            out << total;
+        }
+    }
+    out << "\n";
+}
+
+bool runSweep(const SimConfig& base, const vector<const SchedulerEntry*>& schedulers,
+              const vector<SweepAxis>& axes, ostream& out, string& error) {
+    vector<SweepPoint> points = expandSweep(schedulers, axes);
+
+    // Build and check every config before spending time on any run
+    vector<SimConfig> configs;
+    configs.reserve(points.size());
+    for (const SweepPoint& point : points) {
+        SimConfig config = base;
+        for (size_t a = 0; a < axes.size(); a++) {
+            if (!setConfigValue(config, axes[a].key, point.values[a], error)) {
+                return false;
+            }
+        }
+        if (!validateConfig(config, error) || !loadVoqWeights(config, error) || !loadDestinationMatrix(config, error) ||
+            !loadTrace(config, error)) {
+            return false;
+        }
+        configs.push_back(config);
+    }
+
+    // Every row records its seed, so any point can be rerun on its own
+    string seed = to_string(base.seed);
+    out << "scheduler";
+    for (const SweepAxis& axis : axes) {
+        out << "," << axis.key;
+        if (axis.key == "seed") {
+            seed.clear();
+        }
+    }
+    if (!seed.empty()) {
+        out << ",seed";
+    }
+    out << ",arrivals,processed,input_drops,output_drops,departed,throughput,goodput,avg_waiting,avg_output_delay,delay_p50,delay_p99,delay_p999,delay_max";
+    bool occupancy = base.occupancy;
+    bool profiled = base.profile;
+    for (const SweepAxis& axis : axes) {
+        occupancy = occupancy || axis.key == "occupancy";
+        profiled = profiled || axis.key == "profile";
+    }
+    if (occupancy) {
+        out << ",buffer_mean,buffer_p99,buffer_peak,voq_p99,voq_peak";
+    }
+    if (profiled) {
+        for (int p = 0; p < PROFILE_PHASES; p++) {
+            out << ",ns_" << profilePhaseName(p);
+        }
+        out << ",ns_total";
+    }
+    out << "\n";
+
+    // Runs finish in any order; rows are written in grid order as soon as
+    // every earlier point is done, so the file is the same for any thread count
+    vector<RunSummary> summaries(points.size());
+    vector<char> finished(points.size(), 0);
+    size_t written = 0;
+    mutex outputLock;
+    int threads = base.threads > 0 ? base.threads : hardwareThreads();
+    runTasks((int)points.size(), threads, [&](int p) {
+        RunSummary summary = points[p].scheduler->run(configs[p], nullptr);
+        lock_guard<mutex> guard(outputLock);
+        summaries[p] = summary;
+        finished[p] = 1;
+        for (; written < points.size() && finished[written]; written++) {
+            writeRow(out, points[written], summaries[written], seed, occupancy, profiled);
+        }
+        out.flush();
+    });
+    return true;
+}
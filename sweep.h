@@ -0,0 +1,36 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "scheduler_registry.h"
+#include "sim_config.h"
+
+// One dimension of a parameter grid: a config key and the values it takes
+struct SweepAxis {
+    std::string key;
+    std::vector<std::string> values;
+};
+
+// One grid point: the scheduler and the value of every axis, in axis order
+struct SweepPoint {
+    const SchedulerEntry* scheduler;
+    std::vector<std::string> values;
+};
+
+// Parses "key=spec" where spec is a comma list ("uniform,bursty") or, for
+// numeric keys, an inclusive range "first:last:step" ("0.1:1.0:0.1").
+bool parseSweepAxis(const std::string& text, SweepAxis& axis, std::string& error);
+
+// Every combination of the schedulers and axis values, schedulers outermost
+std::vector<SweepPoint> expandSweep(const std::vector<const SchedulerEntry*>& schedulers,
+                                    const std::vector<SweepAxis>& axes);
+
+// Runs every point in this process on top of base, spread over base.threads
+// workers, and writes a CSV header plus one row per point to out in grid
+// order. Fails before running anything if a point does not make a valid config.
+bool runSweep(const SimConfig& base, const std::vector<const SchedulerEntry*>& schedulers,
+              const std::vector<SweepAxis>& axes, std::ostream& out, std::string& error);
+
+#endif
@@ -0,0 +1,278 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "packet.h"
+#include "trace_file.h"
+
+using namespace std;
+
+// Counts and bounds shared by both input formats
+struct ConvertState {
+    TraceWriter writer;
+    int numPorts = 0;          // Fixed by --ports, else grows with the records
+    bool fixedPorts = false;
+    bool started = false;
+    uint64_t origin = 0;       // First timestamp; the trace starts at 0
+    uint64_t last = 0;         // Latest timestamp written
+    long long written = 0;
+    long long skipped = 0;     // Frames that are not IP, or malformed
+    long long reordered = 0;   // Records stamped before their predecessor
+};
+
+static void printUsage(const char* program) {
+    cout << "Usage: " << program << " [--ports N] INPUT OUTPUT" << endl;
+    cout << "Converts a pcap capture or a CSV file into the binary trace replayed by" << endl;
+    cout << "router_sim --trace_file." << endl;
+    cout << "  pcap: Ethernet, Linux cooked or raw IP. Input and output ports hash the" << endl;
+    cout << "        source and destination addresses over --ports (default 8); DSCP 40" << endl;
+    cout << "        and up is class 0, 8 and up class 1, the rest class 2." << endl;
+    cout << "  CSV:  timestamp_ns,input,output,size_bytes,class per line. Without --ports" << endl;
+    cout << "        the trace has one port more than the highest one used." << endl;
+}
+
+// Timestamps are made relative to the first record. One that goes back in
+// time (interleaved capture queues) is moved up to its predecessor, so the
+// trace stays sorted and can be written in a single pass.
+static void emit(ConvertState& state, uint64_t timestamp, int input, int output, int size, int cls) {
+    if (!state.started) {
+        state.origin = timestamp;
+        state.started = true;
+    }
+    uint64_t relative = timestamp > state.origin ? timestamp - state.origin : 0;
+    if (relative < state.last) {
+        relative = state.last;
+        state.reordered++;
+    }
+    state.last = relative;
+
+    TraceRecord record = {};
+    record.timestamp = relative;
+    record.inputPort = (uint16_t)input;
+    record.outputPort = (uint16_t)output;
+    record.size = (uint16_t)size;
+    record.trafficClass = (uint8_t)cls;
+    state.writer.append(record);
+    state.written++;
+    if (!state.fixedPorts && max(input, output) >= state.numPorts) {
+        state.numPorts = max(input, output) + 1;
+    }
+}
+
+// FNV-1a over an address, folded onto the ports
+static int hashPort(const unsigned char* address, int length, int numPorts) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (int k = 0; k < length; k++) {
+        hash = (hash ^ address[k]) * 0x100000001B3ull;
+    }
+    return (int)((hash ^ (hash >> 32)) % (uint64_t)numPorts);
+}
+
+static int dscpClass(int dscp) {
+    return dscp >= 40 ? 0 : dscp >= 8 ? 1 : 2;
+}
+
+static uint32_t swap32(uint32_t value) {
+    return __builtin_bswap32(value);
+}
+
+// Classic libpcap files, either byte order, micro- or nanosecond stamps
+static bool convertPcap(FILE* in, ConvertState& state, string& error) {
+    unsigned char global[24];
+    if (fread(global, 1, sizeof(global), in) != sizeof(global)) {
+        error = "truncated pcap header";
+        return false;
+    }
+    uint32_t magic, linkType;
+    memcpy(&magic, global, 4);
+    memcpy(&linkType, global + 20, 4);
+    bool swapped = magic == 0xD4C3B2A1u || magic == 0x4D3CB2A1u;
+    if (swapped) {
+        magic = swap32(magic);
+        linkType = swap32(linkType);
+    }
+    uint64_t fractionNanos = magic == 0xA1B23C4Du ? 1 : 1000;
+    int linkHeader;
+    if (linkType == 1) {
+        linkHeader = 14;  // Ethernet
+    } else if (linkType == 113) {
+        linkHeader = 16;  // Linux cooked capture
+    } else if (linkType == 101 || linkType == 228 || linkType == 229) {
+        linkHeader = 0;   // Raw IP
+    } else {
+        error = "unsupported pcap link type " + to_string(linkType);
+        return false;
+    }
+
+    vector<unsigned char> frame;
+    uint32_t fields[4];
+    while (fread(fields, sizeof(fields), 1, in) == 1) {
+        if (swapped) {
+            for (uint32_t& field : fields) {
+                field = swap32(field);
+            }
+        }
+        uint64_t timestamp = (uint64_t)fields[0] * 1000000000ull + fields[1] * fractionNanos;
+        uint32_t captured = fields[2];
+        uint32_t wireLength = fields[3];
+        frame.resize(captured);
+        if (captured > 0 && fread(frame.data(), 1, captured, in) != captured) {
+            error = "truncated pcap record";
+            return false;
+        }
+
+        // Find the IP header behind the link header and any VLAN tags
+        size_t offset = linkHeader;
+        int etherType = -1;
+        if (linkType == 1 && captured >= 14) {
+            etherType = frame[12] << 8 | frame[13];
+            while ((etherType == 0x8100 || etherType == 0x88A8) && captured >= offset + 4) {
+                etherType = frame[offset + 2] << 8 | frame[offset + 3];
+                offset += 4;
+            }
+        } else if (linkType == 113 && captured >= 16) {
+            etherType = frame[14] << 8 | frame[15];
+        }
+        int version = captured > offset ? frame[offset] >> 4 : 0;
+        if (etherType == 0x0800 || (linkHeader == 0 && version == 4)) {
+            if (captured < offset + 20) {
+                state.skipped++;
+                continue;
+            }
+            const unsigned char* ip = &frame[offset];
+            emit(state, timestamp, hashPort(ip + 12, 4, state.numPorts), hashPort(ip + 16, 4, state.numPorts),
+                 (int)min(wireLength, 65535u), dscpClass(ip[1] >> 2));
+        } else if (etherType == 0x86DD || (linkHeader == 0 && version == 6)) {
+            if (captured < offset + 40) {
+                state.skipped++;
+                continue;
+            }
+            const unsigned char* ip = &frame[offset];
+            int trafficClass = (ip[0] & 0x0F) << 4 | ip[1] >> 4;
+            emit(state, timestamp, hashPort(ip + 8, 16, state.numPorts), hashPort(ip + 24, 16, state.numPorts),
+                 (int)min(wireLength, 65535u), dscpClass(trafficClass >> 2));
+        } else {
+            state.skipped++;
+        }
+    }
+    if (ferror(in)) {
+        error = "error reading the pcap file";
+        return false;
+    }
+    return true;
+}
+
+static bool convertCsv(FILE* in, ConvertState& state, string& error) {
+    char line[512];
+    int lineNumber = 0;
+    while (fgets(line, sizeof(line), in)) {
+        lineNumber++;
+        // Comments, blank lines and a header row
+        if (line[0] == '#' || line[0] < '0' || line[0] > '9') {
+            continue;
+        }
+        char* cursor = line;
+        char* end;
+        unsigned long long fields[5];
+        int parsed = 0;
+        for (; parsed < 5; parsed++) {
+            fields[parsed] = strtoull(cursor, &end, 10);
+            if (end == cursor) {
+                break;
+            }
+            cursor = end + (*end == ',');
+        }
+        string where = "line " + to_string(lineNumber) + ": ";
+        if (parsed < 5) {
+            error = where + "expected timestamp_ns,input,output,size_bytes,class";
+            return false;
+        }
+        unsigned long long portLimit = state.fixedPorts ? state.numPorts : 65535;
+        if (fields[1] >= portLimit || fields[2] >= portLimit) {
+            error = where + "port out of range";
+            return false;
+        }
+        if (fields[3] > 65535) {
+            error = where + "size above 65535 bytes";
+            return false;
+        }
+        if (fields[4] >= (unsigned long long)NUM_CLASSES) {
+            error = where + "class must be below " + to_string(NUM_CLASSES);
+            return false;
+        }
+        emit(state, fields[0], (int)fields[1], (int)fields[2], (int)fields[3], (int)fields[4]);
+    }
+    if (ferror(in)) {
+        error = "error reading the CSV file";
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    ConvertState state;
+    vector<string> paths;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--ports" && i + 1 < argc) {
+            istringstream value(argv[++i]);
+            value >> state.numPorts;
+            if (!value || !value.eof() || state.numPorts < 1 || state.numPorts > 65535) {
+                cout << "Error: --ports must be between 1 and 65535" << endl;
+                return 1;
+            }
+            state.fixedPorts = true;
+        } else {
+            paths.push_back(arg);
+        }
+    }
+    if (paths.size() != 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    FILE* in = fopen(paths[0].c_str(), "rb");
+    if (!in) {
+        cout << "Error: cannot open '" << paths[0] << "'" << endl;
+        return 1;
+    }
+    uint32_t magic = 0;
+    bool pcap = fread(&magic, sizeof(magic), 1, in) == 1 &&
+                (magic == 0xA1B2C3D4u || magic == 0xD4C3B2A1u || magic == 0xA1B23C4Du || magic == 0x4D3CB2A1u);
+    rewind(in);
+    if (pcap && !state.fixedPorts) {
+        state.numPorts = 8;
+        state.fixedPorts = true;
+    }
+
+    string error;
+    if (!state.writer.open(paths[1], error)) {
+        fclose(in);
+        cout << "Error: " << error << endl;
+        return 1;
+    }
+    bool ok = pcap ? convertPcap(in, state, error) : convertCsv(in, state, error);
+    fclose(in);
+    if (!ok) {
+        cout << "Error: " << paths[0] << ": " << error << endl;
+        return 1;
+    }
+    if (!state.writer.close(max(state.numPorts, 1), error)) {
+        cout << "Error: " << paths[1] << ": " << error << endl;
+        return 1;
+    }
+
+    cout << "Wrote " << state.written << " packets over " << max(state.numPorts, 1) << " ports, "
+         << state.last << " ns" << endl;
+    if (state.skipped) {
+        cout << "Skipped " << state.skipped << " frames that are not IPv4 or IPv6" << endl;
+    }
+    if (state.reordered) {
+        cout << "Moved " << state.reordered << " out-of-order packets up to their predecessor's time" << endl;
+    }
+    return 0;
+}
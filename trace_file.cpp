@@ -0,0 +1,168 @@
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "trace_file.h"
+
+using namespace std;
+
+static const size_t WRITE_BATCH = 4096; // Records per write
+
+// Read-only map of a whole file, or nullptr; the mapping keeps the file
+// open by itself. Replay reads front to back once, so the kernel is told to
+// read ahead and drop pages behind.
+static void* mapFile(const string& path, size_t& length) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+    LARGE_INTEGER size;
+    HANDLE section = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        section = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    CloseHandle(file);
+    if (!section) {
+        return nullptr;
+    }
+    void* mapping = MapViewOfFile(section, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(section);
+    length = (size_t)size.QuadPart;
+    return mapping;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat info;
+    void* mapping = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        length = (size_t)info.st_size;
+        mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+    madvise(mapping, length, MADV_SEQUENTIAL);
+    return mapping;
+#endif
+}
+
+TraceFile::~TraceFile() {
+    if (mapping) {
+#ifdef _WIN32
+        UnmapViewOfFile(mapping);
+#else
+        munmap(mapping, length);
+#endif
+    }
+}
+
+bool TraceFile::open(const string& path, string& error) {
+    filePath = path;
+    mapping = mapFile(path, length);
+    if (!mapping) {
+        error = "cannot open trace file '" + path + "'";
+        return false;
+    }
+    if (length < sizeof(TraceHeader)) {
+        error = path + ": not a trace file";
+        return false;
+    }
+
+    const TraceHeader& h = header();
+    if (memcmp(h.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0) {
+        error = path + ": not a trace file";
+        return false;
+    }
+    if (h.version != TRACE_VERSION) {
+        error = path + ": unsupported trace version " + to_string(h.version);
+        return false;
+    }
+    if (h.count > (length - sizeof(TraceHeader)) / sizeof(TraceRecord)) {
+        error = path + ": truncated, header promises " + to_string(h.count) + " records";
+        return false;
+    }
+    recordCount = (size_t)h.count;
+    return true;
+}
+
+TraceWriter::~TraceWriter() {
+    if (file) {
+        fclose(file);
+    }
+}
+
+bool TraceWriter::open(const string& path, string& error) {
+    file = fopen(path.c_str(), "wb");
+    if (!file) {
+        error = "cannot write '" + path + "'";
+        return false;
+    }
+    count = 0;
+    pending.clear();
+    pending.reserve(WRITE_BATCH);
+    // Placeholder until close() knows the count
+    TraceHeader header = {};
+    fwrite(&header, sizeof(header), 1, file);
+    return true;
+}
+
+void TraceWriter::append(const TraceRecord& record) {
+    pending.push_back(record);
+    if (pending.size() == WRITE_BATCH) {
+        flush();
+    }
+}
+
+void TraceWriter::flush() {
+    fwrite(pending.data(), sizeof(TraceRecord), pending.size(), file);
+    count += pending.size();
+    pending.clear();
+}
+
+bool TraceWriter::close(int numPorts, string& error) {
+    flush();
+    TraceHeader header = {};
+    memcpy(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    header.version = TRACE_VERSION;
+    header.numPorts = (uint32_t)numPorts;
+    header.count = count;
+    bool ok = fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = !ferror(file) && ok;
+    ok = fclose(file) == 0 && ok;
+    file = nullptr;
+    if (!ok) {
+        error = "error writing the trace";
+    }
+    return ok;
+}
+
+bool loadTrace(SimConfig& config, string& error) {
+    if (config.traffic != TRAFFIC_TRACE) {
+        config.trace.reset();
+        return true;
+    }
+    // Sweep points that keep the base trace keep its mapping
+    if (!config.trace || config.trace->path() != config.traceFile) {
+        shared_ptr<TraceFile> trace(new TraceFile());
+        if (!trace->open(config.traceFile, error)) {
+            return false;
+        }
+        config.trace = trace;
+    }
+    if ((int)config.trace->header().numPorts > config.numPorts) {
+        error = config.traceFile + ": trace uses " + to_string(config.trace->header().numPorts) +
+                " ports, more than the switch has";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,87 @@
+#ifndef TRACE_FILE_H
+#define TRACE_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include "sim_config.h"
+
+// Binary packet trace: a TraceHeader followed by count TraceRecords sorted
+// by timestamp, all little-endian. Records are fixed-size and aligned, so a
+// mapped file is read in place as an array.
+const char TRACE_MAGIC[8] = {'V', 'O', 'Q', 'T', 'R', 'A', 'C', 'E'};
+const uint32_t TRACE_VERSION = 1;
+const int TRACE_SIZE_UNIT = 64; // Bytes per unit of Packet::size on replay
+
+struct TraceHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t numPorts; // Every input and output in the records is below this
+    uint64_t count;    // Records that follow
+    uint64_t reserved;
+};
+
+struct TraceRecord {
+    uint64_t timestamp;  // Nanoseconds since the start of the trace
+    uint16_t inputPort;
+    uint16_t outputPort;
+    uint16_t size;       // Bytes on the wire
+    uint8_t trafficClass; // 0 = highest, below NUM_CLASSES
+    uint8_t reserved;
+};
+
+static_assert(sizeof(TraceHeader) == 32, "trace header layout");
+static_assert(sizeof(TraceRecord) == 16, "trace record layout");
+
+// Read-only memory map of a trace file. Replay walks records directly out of
+// the page cache, so nothing is copied or allocated per packet and every run
+// sharing the map shares the pages.
+class TraceFile {
+public:
+    TraceFile() {}
+    ~TraceFile();
+    TraceFile(const TraceFile&) = delete;
+    TraceFile& operator=(const TraceFile&) = delete;
+
+    // Maps path and checks its header; false and error on failure
+    bool open(const std::string& path, std::string& error);
+
+    const TraceHeader& header() const { return *(const TraceHeader*)mapping; }
+    const TraceRecord* records() const { return (const TraceRecord*)((const char*)mapping + sizeof(TraceHeader)); }
+    size_t count() const { return recordCount; }
+    const std::string& path() const { return filePath; }
+
+private:
+    std::string filePath;
+    void* mapping = nullptr;
+    size_t length = 0;
+    size_t recordCount = 0;
+};
+
+// Writes a trace one record at a time through a buffer, then fills in the
+// header count on close. Records must be appended in timestamp order.
+class TraceWriter {
+public:
+    ~TraceWriter();
+
+    bool open(const std::string& path, std::string& error);
+    void append(const TraceRecord& record);
+    // numPorts goes in the header, above every port appended
+    bool close(int numPorts, std::string& error);
+
+private:
+    void flush();
+
+    FILE* file = nullptr;
+    uint64_t count = 0;
+    std::vector<TraceRecord> pending;
+};
+
+// Maps config.traceFile into config.trace for trace traffic. The trace may
+// use fewer ports than the switch but not more.
+bool loadTrace(SimConfig& config, std::string& error);
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef VOQ_BITMAPS_H
+#define VOQ_BITMAPS_H
+
+#include <vector>
+#include "port_mask.h"
+
+// Which VOQs hold packets, as port bitmaps in both directions. The engine
+// updates them when a VOQ turns non-empty or empty, so schedulers can read
+// requests directly instead of polling all numPorts^2 queues every slot.
+class VoqBitmaps {
+public:
+    explicit VoqBitmaps(int numPorts)
+        : words(maskWords(numPorts)),
+          inputRows(numPorts * words, 0),
+          outputRows(numPorts * words, 0),
+          activeInputMask(words, 0),
+          activeOutputMask(words, 0) {}
+
+    int maskWordCount() const { return words; }
+
+    // Outputs the input has packets for
+    const MaskWord* byInput(int inputPort) const { return &inputRows[inputPort * words]; }
+    // Inputs with packets for the output
+    const MaskWord* byOutput(int outputPort) const { return &outputRows[outputPort * words]; }
+    // All byOutput() rows back to back, maskWordCount() words apart
+    const MaskWord* outputMatrix() const { return outputRows.data(); }
+    const MaskWord* activeInputs() const { return activeInputMask.data(); }
+    const MaskWord* activeOutputs() const { return activeOutputMask.data(); }
+
+    // VOQ (input, output) went from empty to non-empty
+    void set(int inputPort, int outputPort) {
+        setPort(&inputRows[inputPort * words], outputPort);
+        setPort(&outputRows[outputPort * words], inputPort);
+        setPort(activeInputMask.data(), inputPort);
+        setPort(activeOutputMask.data(), outputPort);
+    }
+
+    // VOQ (input, output) went from non-empty to empty
+    void clear(int inputPort, int outputPort) {
+        MaskWord* inputRow = &inputRows[inputPort * words];
+        MaskWord* outputRow = &outputRows[outputPort * words];
+        clearPort(inputRow, outputPort);
+        clearPort(outputRow, inputPort);
+        if (maskEmpty(inputRow, words)) {
+            clearPort(activeInputMask.data(), inputPort);
+        }
+        if (maskEmpty(outputRow, words)) {
+            clearPort(activeOutputMask.data(), outputPort);
+        }
+    }
+
+private:
+    int words;
+    std::vector<MaskWord> inputRows;
+    std::vector<MaskWord> outputRows;
+    std::vector<MaskWord> activeInputMask;
+    std::vector<MaskWord> activeOutputMask;
+};
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef VOQ_BUFFER_H
+#define VOQ_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "packet.h"
+
+// What a VOQ actually stores per cell. The output port and the class are
+// implied by the queue the cell sits in, so only the fields read on the
+// dequeue path are kept. Every cell of a packet carries the packet's fields;
+// without segmentation a packet is a single cell marked first and last.
+struct Cell {
+    int32_t arrivalTime;
+    uint16_t size;          // Size of the whole packet
+    uint8_t processingTime;
+    uint8_t flags;          // CELL_FIRST, CELL_LAST and the class
+};
+
+const uint8_t CELL_FIRST = 1; // First cell of its packet
+const uint8_t CELL_LAST = 2;  // Last cell of its packet
+const int CELL_CLASS_SHIFT = 2; // The traffic class sits in the bits above
+
+inline int cellClass(const Cell& cell) { return cell.flags >> CELL_CLASS_SHIFT; }
+
+const uint16_t NO_SLOT = 0xFFFF;
+const int MAX_BUFFER_SIZE = NO_SLOT - 1;
+
+// VOQ matrix stored flat: VOQ (input, output) is index input * numPorts + output.
+// Every VOQ owns bufferSize cells carved out of one arena. The per-class
+// FIFOs are threaded through the VOQ's slots by 16-bit links, so the classes
+// share the VOQ's depth limit and nothing is allocated after start-up.
+// Arena pages are only touched once a VOQ actually holds that many packets.
+class VoqBuffers {
+public:
+    VoqBuffers(int numPorts, int bufferSize)
+        : numPorts(numPorts),
+          bufferSize(bufferSize),
+          state(numPorts * numPorts),
+          cells(new Cell[(size_t)numPorts * numPorts * bufferSize]),
+          links(new uint16_t[(size_t)numPorts * numPorts * bufferSize]) {}
+
+    int index(int inputPort, int outputPort) const { return inputPort * numPorts + outputPort; }
+
+    int size(int voq) const { return state[voq].count; }
+    bool full(int voq) const { return state[voq].count >= bufferSize; }
+    bool empty(int voq, int cls) const { return !(state[voq].classMask & (1u << cls)); }
+    unsigned classMask(int voq) const { return state[voq].classMask; }
+
+    const Cell& front(int voq, int cls) const {
+        return cells[base(voq) + state[voq].head[cls]];
+    }
+
+    // Caller checks full() first
+    void push(int voq, int cls, const Cell& cell) {
+        VoqState& s = state[voq];
+        size_t first = base(voq);
+        uint16_t slot;
+        if (s.freeHead != NO_SLOT) {
+            slot = s.freeHead;
+            s.freeHead = links[first + slot];
+        } else {
+            slot = s.fresh++;
+        }
+        cells[first + slot] = cell;
+        links[first + slot] = NO_SLOT;
+        if (s.classMask & (1u << cls)) {
+            links[first + s.tail[cls]] = slot;
+        } else {
+            s.head[cls] = slot;
+            s.classMask |= 1u << cls;
+        }
+        s.tail[cls] = slot;
+        s.count++;
+    }
+
+    void pop(int voq, int cls) {
+        VoqState& s = state[voq];
+        size_t first = base(voq);
+        uint16_t slot = s.head[cls];
+        uint16_t next = links[first + slot];
+        if (next == NO_SLOT) {
+            s.classMask &= ~(1u << cls);
+        } else {
+            s.head[cls] = next;
+        }
+        links[first + slot] = s.freeHead;
+        s.freeHead = slot;
+        s.count--;
+    }
+
+private:
+    struct VoqState {
+        uint16_t count = 0;
+        uint16_t fresh = 0;          // Slots below this have been used at least once
+        uint16_t freeHead = NO_SLOT; // Recycled slots
+        uint16_t head[NUM_CLASSES];
+        uint16_t tail[NUM_CLASSES];
+        uint8_t classMask = 0;       // Bit c set when class c is non-empty
+    };
+
+    size_t base(int voq) const { return (size_t)voq * bufferSize; }
+
+    int numPorts;
+    int bufferSize;
+    std::vector<VoqState> state;
+    std::unique_ptr<Cell[]> cells;
+    std::unique_ptr<uint16_t[]> links;
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef WAVEFRONT_H
+#define WAVEFRONT_H
+
+#include "matching_scheduler.h"
+
+// Wrapped wavefront arbiter: the request matrix is swept one wrapped
+// diagonal at a time. Cells on a diagonal share no row or column, so each
+// is granted if it has a request and its input and output are still free.
+// The diagonal that goes first rotates every slot for fairness.
+class WavefrontScheduler : public MatchingScheduler {
+public:
+    int topDiagonal = 0;
+
+    explicit WavefrontScheduler(const SimConfig& config) : MatchingScheduler(config) {}
+
+    template <class Switch>
+    void processPackets(Switch& sw, int time);
+};
+
+template <class Switch>
+void WavefrontScheduler::processPackets(Switch& sw, int time) {
+    const MaskWord* activeInputs = sw.occupied.activeInputs();
+    if (maskEmpty(activeInputs, words)) {
+        return;
+    }
+    resetMatching();
+
+    // Diagonal d holds the cells (i, (i + d) mod numPorts)
+    for (int wave = 0; wave < numPorts; wave++) {
+        int diagonal = topDiagonal + wave < numPorts ? topDiagonal + wave : topDiagonal + wave - numPorts;
+        bool anyFree = false;
+        for (int w = 0; w < words; w++) {
+            MaskWord inputs = activeInputs[w] & freeInputs[w];
+            anyFree |= inputs != 0;
+            while (inputs) {
+                int inputPort = (w << 6) + __builtin_ctzll(inputs);
+                inputs &= inputs - 1;
+                int outputPort = inputPort + diagonal < numPorts ? inputPort + diagonal : inputPort + diagonal - numPorts;
+                if (testPort(sw.occupied.byInput(inputPort), outputPort) && testPort(freeOutputs.data(), outputPort)) {
+                    addMatch(inputPort, outputPort);
+                }
+            }
+        }
+        if (!anyFree) {
+            break;
+        }
+    }
+    topDiagonal = topDiagonal + 1 == numPorts ? 0 : topDiagonal + 1;
+
+    transmitMatches(sw, time);
+}
+
+#endif
@@ -0,0 +1,297 @@
+#ifndef WFQ_VOQ_H
+#define WFQ_VOQ_H
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "rr_voq.h"
+
+// Weight of VOQ input * numPorts + output; every VOQ weighs 1 without a weights file
+inline int voqWeight(const SimConfig& config, int voq) {
+    return config.voqWeights.empty() ? 1 : config.voqWeights[voq];
+}
+
+// Deficit round robin: each output serves its backlogged inputs in turn. A
+// VOQ's turn starts by adding quantum * weight to its deficit and lasts while
+// the deficit covers the head packet; a VOQ that empties gives up its deficit.
+// One cell leaves each output per scheduling phase, so a turn can span several
+// phases, and inputs already matched in this phase are passed over without
+// losing their turn.
+class DrrScheduler : public SchedulerBase {
+public:
+    ClassRoundRobin classes;
+    std::vector<int> quantum;      // Credit per turn, per VOQ
+    std::vector<int> deficit;      // Per VOQ
+    std::vector<char> inTurn;      // Per VOQ, quantum already added for the current turn
+
+    // Per-output lists of backlogged inputs, linked through per-VOQ next/prev
+    std::vector<int> head;
+    std::vector<int> tail;
+    std::vector<int> next;
+    std::vector<int> prev;
+    std::vector<char> listed;
+
+    std::vector<long long> inputMatchedAt; // Phase in which each input was last matched
+
+    explicit DrrScheduler(const SimConfig& config)
+        : SchedulerBase(config),
+          classes(numPorts),
+          quantum(numPorts * numPorts),
+          deficit(numPorts * numPorts, 0),
+          inTurn(numPorts * numPorts, 0),
+          head(numPorts, -1),
+          tail(numPorts, -1),
+          next(numPorts * numPorts, -1),
+          prev(numPorts * numPorts, -1),
+          listed(numPorts * numPorts, 0),
+          inputMatchedAt(numPorts, -1) {
+        for (int voq = 0; voq < numPorts * numPorts; voq++) {
+            quantum[voq] = config.quantum * voqWeight(config, voq);
+        }
+    }
+
+    void onEnqueue(int inputPort, int outputPort, int time) {
+        if (!listed[inputPort * numPorts + outputPort]) {
+            append(inputPort, outputPort);
+        }
+    }
+
+    template <class Switch>
+    void processPackets(Switch& sw, int time);
+
+private:
+    void append(int inputPort, int outputPort) {
+        int voq = inputPort * numPorts + outputPort;
+        listed[voq] = 1;
+        next[voq] = -1;
+        prev[voq] = tail[outputPort];
+        if (tail[outputPort] == -1) {
+            head[outputPort] = inputPort;
+        } else {
+            next[tail[outputPort] * numPorts + outputPort] = inputPort;
+        }
+        tail[outputPort] = inputPort;
+    }
+
+    void unlink(int inputPort, int outputPort) {
+        int voq = inputPort * numPorts + outputPort;
+        listed[voq] = 0;
+        if (prev[voq] == -1) {
+            head[outputPort] = next[voq];
+        } else {
+            next[prev[voq] * numPorts + outputPort] = next[voq];
+        }
+        if (next[voq] == -1) {
+            tail[outputPort] = prev[voq];
+        } else {
+            prev[next[voq] * numPorts + outputPort] = prev[voq];
+        }
+    }
+};
+
+template <class Switch>
+void DrrScheduler::processPackets(Switch& sw, int time) {
+    // Rotate which output picks first so no input is always claimed by the same output
+    for (int n = 0; n < numPorts; n++) {
+        int outputPort = (int)((sw.phase + n) % numPorts);
+        int inputPort = sw.outputBusy(outputPort) ? -1 : head[outputPort];
+        while (inputPort != -1) {
+            int voq = inputPort * numPorts + outputPort;
+            if (inputMatchedAt[inputPort] == sw.phase || sw.inputBusy(inputPort)) {
+                inputPort = next[voq];
+                continue;
+            }
+            if (!inTurn[voq]) {
+                deficit[voq] += quantum[voq];
+                inTurn[voq] = 1;
+            }
+            int priority = classes.nextClass(sw, inputPort, outputPort);
+            int size = sw.serviceSize(sw.headCell(inputPort, outputPort, priority));
+            if (deficit[voq] < size) {
+                // Turn over: keep the remaining deficit and go to the back of the list
+                int following = next[voq];
+                inTurn[voq] = 0;
+                unlink(inputPort, outputPort);
+                append(inputPort, outputPort);
+                inputPort = following != -1 ? following : head[outputPort];
+                continue;
+            }
+            deficit[voq] -= size;
+            inputMatchedAt[inputPort] = sw.phase;
+            sw.transmit(inputPort, outputPort, priority, time);
+            classes.advance(inputPort, outputPort, priority);
+            if (!sw.hasPackets(inputPort, outputPort)) {
+                deficit[voq] = 0;
+                inTurn[voq] = 0;
+                unlink(inputPort, outputPort);
+            }
+            break;
+        }
+    }
+}
+
+// WF2Q+: every backlogged VOQ of an output carries virtual start and finish
+// times for its head packet, its rate being its share of the output's total
+// weight. Each output keeps its own virtual time and sends the eligible VOQ
+// (start <= virtual time) with the smallest finish time. Eligible and waiting
+// VOQs sit in two binary heaps per output, so a decision costs O(log n).
+class Wf2qScheduler : public SchedulerBase {
+public:
+    typedef std::pair<double, int> HeapEntry; // (timestamp, input port)
+
+    ClassRoundRobin classes;
+    std::vector<double> virtualTime;   // Per output
+    std::vector<double> finishScale;   // Per VOQ, output weight total / VOQ weight
+    std::vector<double> startTime;     // Per VOQ, head packet
+    std::vector<double> finishTime;    // Per VOQ, head packet, or last packet once idle
+    std::vector<int> headClass;        // Per VOQ, class the timestamps were taken for
+    std::vector<char> backlogged;      // Per VOQ
+    std::vector<int> activated;        // VOQs that became backlogged since the last slot
+
+    std::vector<std::vector<HeapEntry>> eligible; // Per output, min-heap on finish time
+    std::vector<std::vector<HeapEntry>> waiting;  // Per output, min-heap on start time
+    std::vector<HeapEntry> deferred;              // Heap entries whose input was taken this phase
+    std::vector<long long> inputMatchedAt;
+
+    explicit Wf2qScheduler(const SimConfig& config)
+        : SchedulerBase(config),
+          classes(numPorts),
+          virtualTime(numPorts, 0.0),
+          finishScale(numPorts * numPorts),
+          startTime(numPorts * numPorts, 0.0),
+          finishTime(numPorts * numPorts, 0.0),
+          headClass(numPorts * numPorts, 0),
+          backlogged(numPorts * numPorts, 0),
+          eligible(numPorts),
+          waiting(numPorts),
+          inputMatchedAt(numPorts, -1) {
+        for (int outputPort = 0; outputPort < numPorts; outputPort++) {
+            double total = 0;
+            for (int inputPort = 0; inputPort < numPorts; inputPort++) {
+                total += voqWeight(config, inputPort * numPorts + outputPort);
+            }
+            for (int inputPort = 0; inputPort < numPorts; inputPort++) {
+                int voq = inputPort * numPorts + outputPort;
+                finishScale[voq] = total / voqWeight(config, voq);
+            }
+            eligible[outputPort].reserve(numPorts);
+            waiting[outputPort].reserve(numPorts);
+        }
+        activated.reserve(numPorts * numPorts);
+        deferred.reserve(numPorts);
+    }
+
+    // Timestamps need the head packet, so new VOQs are stamped at the next decision
+    void onEnqueue(int inputPort, int outputPort, int time) {
+        int voq = inputPort * numPorts + outputPort;
+        if (!backlogged[voq]) {
+            backlogged[voq] = 1;
+            activated.push_back(voq);
+        }
+    }
+
+    template <class Switch>
+    void processPackets(Switch& sw, int time);
+
+private:
+    static void pushHeap(std::vector<HeapEntry>& heap, HeapEntry entry) {
+        heap.push_back(entry);
+        std::push_heap(heap.begin(), heap.end(), std::greater<HeapEntry>());
+    }
+
+    static HeapEntry popHeap(std::vector<HeapEntry>& heap) {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<HeapEntry>());
+        HeapEntry entry = heap.back();
+        heap.pop_back();
+        return entry;
+    }
+
+    // Stamps the VOQ's next head packet, starting no earlier than start
+    template <class Switch>
+    void stamp(const Switch& sw, int inputPort, int outputPort, double start) {
+        int voq = inputPort * numPorts + outputPort;
+        int priority = classes.nextClass(sw, inputPort, outputPort);
+        headClass[voq] = priority;
+        startTime[voq] = start;
+        finishTime[voq] = start + sw.serviceSize(sw.headCell(inputPort, outputPort, priority)) * finishScale[voq];
+        if (start <= virtualTime[outputPort]) {
+            pushHeap(eligible[outputPort], HeapEntry(finishTime[voq], inputPort));
+        } else {
+            pushHeap(waiting[outputPort], HeapEntry(start, inputPort));
+        }
+    }
+};
+
+template <class Switch>
+void Wf2qScheduler::processPackets(Switch& sw, int time) {
+    for (int voq : activated) {
+        int outputPort = voq % numPorts;
+        stamp(sw, voq / numPorts, outputPort, std::max(virtualTime[outputPort], finishTime[voq]));
+    }
+    activated.clear();
+
+    for (int n = 0; n < numPorts; n++) {
+        int outputPort = (int)((sw.phase + n) % numPorts);
+        std::vector<HeapEntry>& ready = eligible[outputPort];
+        std::vector<HeapEntry>& later = waiting[outputPort];
+        if ((ready.empty() && later.empty()) || sw.outputBusy(outputPort)) {
+            continue;
+        }
+        // With nothing eligible, virtual time jumps to the earliest start
+        if (ready.empty()) {
+            virtualTime[outputPort] = std::max(virtualTime[outputPort], later.front().first);
+        }
+        while (!later.empty() && later.front().first <= virtualTime[outputPort]) {
+            int inputPort = popHeap(later).second;
+            pushHeap(ready, HeapEntry(finishTime[inputPort * numPorts + outputPort], inputPort));
+        }
+
+        // Smallest eligible finish time among the free inputs. When every
+        // eligible input is taken, the earliest waiting start is served
+        // instead and virtual time catches up to it, keeping the output busy.
+        int inputPort = -1;
+        while (!ready.empty() && inputPort == -1) {
+            HeapEntry entry = popHeap(ready);
+            if (inputMatchedAt[entry.second] == sw.phase || sw.inputBusy(entry.second)) {
+                deferred.push_back(entry);
+            } else {
+                inputPort = entry.second;
+            }
+        }
+        for (const HeapEntry& entry : deferred) {
+            pushHeap(ready, entry);
+        }
+        deferred.clear();
+        while (!later.empty() && inputPort == -1) {
+            HeapEntry entry = popHeap(later);
+            if (inputMatchedAt[entry.second] == sw.phase || sw.inputBusy(entry.second)) {
+                deferred.push_back(entry);
+            } else {
+                inputPort = entry.second;
+                virtualTime[outputPort] = std::max(virtualTime[outputPort], entry.first);
+            }
+        }
+        for (const HeapEntry& entry : deferred) {
+            pushHeap(later, entry);
+        }
+        deferred.clear();
+        if (inputPort == -1) {
+            continue;
+        }
+
+        int voq = inputPort * numPorts + outputPort;
+        int priority = headClass[voq];
+        virtualTime[outputPort] += sw.serviceSize(sw.headCell(inputPort, outputPort, priority));
+        inputMatchedAt[inputPort] = sw.phase;
+        sw.transmit(inputPort, outputPort, priority, time);
+        classes.advance(inputPort, outputPort, priority);
+        if (sw.hasPackets(inputPort, outputPort)) {
+            stamp(sw, inputPort, outputPort, finishTime[voq]);
+        } else {
+            backlogged[voq] = 0;
+        }
+    }
+}
+
+#endif
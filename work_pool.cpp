@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "work_pool.h"
+
+using namespace std;
+
+struct TaskQueue {
+    mutex lock;
+    deque<int> tasks;
+};
+
+// Next task for worker self: its own front, else the back of the first
+// non-empty queue after it. -1 once every queue is empty.
+static int takeTask(vector<unique_ptr<TaskQueue>>& queues, int self) {
+    {
+        TaskQueue& own = *queues[self];
+        lock_guard<mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            int task = own.tasks.front();
+            own.tasks.pop_front();
+            return task;
+        }
+    }
+    int workers = (int)queues.size();
+    for (int n = 1; n < workers; n++) {
+        TaskQueue& victim = *queues[(self + n) % workers];
+        lock_guard<mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            int task = victim.tasks.back();
+            victim.tasks.pop_back();
+            return task;
+        }
+    }
+    // Tasks never spawn tasks, so empty queues stay empty
+    return -1;
+}
+
+int hardwareThreads() {
+    return max(1, (int)thread::hardware_concurrency());
+}
+
+void runTasks(int count, int threads, const function<void(int)>& task) {
+    int workers = max(1, min(threads, count));
+    if (workers == 1) {
+        for (int i = 0; i < count; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    vector<unique_ptr<TaskQueue>> queues;
+    for (int w = 0; w < workers; w++) {
+        queues.emplace_back(new TaskQueue());
+        for (int i = (long long)count * w / workers; i < (long long)count * (w + 1) / workers; i++) {
+            queues[w]->tasks.push_back(i);
+        }
+    }
+
+    vector<thread> pool;
+    for (int w = 0; w < workers; w++) {
+        pool.emplace_back([&queues, &task, w]() {
+            for (int i = takeTask(queues, w); i != -1; i = takeTask(queues, w)) {
+                task(i);
+            }
+        });
+    }
+    for (thread& worker : pool) {
+        worker.join();
+    }
+}
@@ -0,0 +1,16 @@
+#ifndef WORK_POOL_H
+#define WORK_POOL_H
+
+#include <functional>
+
+// Hardware threads, at least 1
+int hardwareThreads();
+
+// Calls task(0) .. task(count - 1) on up to threads worker threads and
+// returns once all are done. Each worker starts with a contiguous block of
+// indices in its own deque and works from the front; a worker whose deque runs
+// dry steals from the back of another's, so long and short tasks balance out.
+// Tasks must not depend on which thread runs them or in what order.
+void runTasks(int count, int threads, const std::function<void(int)>& task);
+
+#endif